@@ -0,0 +1,133 @@
+#ifndef ALIGNED_ALLOCATOR_HPP
+#define ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#include "Vector.hpp"
+
+
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Allocator for SIMD buffers. Every block starts at a multiple of Alignment bytes and its
+/// size is rounded up to a multiple of Alignment, so with AlignedVector:
+///
+///   - data() is aligned, kernels can use aligned loads without a peeling prologue,
+///   - the buffer always extends to a whole number of Alignment byte vectors past
+///     capacity(), so a kernel may run its last iteration over the padding past size()
+///     instead of a scalar epilogue. The padding holds no elements; reading it is only
+///     meaningful for trivial types.
+///
+/// Also the allocator to use for over-aligned element types. Implements allocate_at_least
+/// (reports the padding) and try_expand (growth into malloc slack, which keeps the start).
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "alignment has to be a power of two");
+    static_assert(Alignment >= alignof(T), "alignment can't be weaker than the element type's");
+    static_assert(Alignment % sizeof(void*) == 0, "posix_memalign needs a multiple of sizeof(void*)");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+    static constexpr size_type alignment = Alignment;
+
+    AlignedAllocator() noexcept {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    pointer allocate(size_type n);
+    allocation_result<pointer, size_type> allocate_at_least(size_type n);
+    void deallocate(pointer p, size_type n) noexcept;
+    bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+
+private:
+    static size_type _padded_bytes(size_type n) noexcept
+    {
+        return (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+    }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator ==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return true; }
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator !=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return false; }
+
+
+template <typename T, std::size_t Alignment = 64, typename G = DefaultGrowth>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>, G>;
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// AlignedAllocator implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, std::size_t Alignment>
+constexpr typename AlignedAllocator<T, Alignment>::size_type AlignedAllocator<T, Alignment>::alignment;
+
+template <typename T, std::size_t Alignment>
+typename AlignedAllocator<T, Alignment>::pointer AlignedAllocator<T, Alignment>::allocate(size_type n)
+{
+    if (n > (std::numeric_limits<size_type>::max() - Alignment) / sizeof(T))
+        throw std::bad_alloc();
+
+    size_type bytes = _padded_bytes(n ? n : 1);
+#if defined(_WIN32)
+    void* p = _aligned_malloc(bytes, Alignment);
+    if (!p)
+        throw std::bad_alloc();
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, Alignment, bytes) != 0)
+        throw std::bad_alloc();
+#endif
+    return static_cast<pointer>(p);
+}
+
+template <typename T, std::size_t Alignment>
+allocation_result<typename AlignedAllocator<T, Alignment>::pointer, typename AlignedAllocator<T, Alignment>::size_type>
+AlignedAllocator<T, Alignment>::allocate_at_least(size_type n)
+{
+    allocation_result<pointer, size_type> block = { allocate(n), _padded_bytes(n) / sizeof(T) };
+    return block;
+}
+
+template <typename T, std::size_t Alignment>
+void AlignedAllocator<T, Alignment>::deallocate(pointer p, size_type) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+template <typename T, std::size_t Alignment>
+bool AlignedAllocator<T, Alignment>::try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+{
+    if (new_n <= old_n)
+        return new_n == old_n;
+#if defined(__GLIBC__)
+    return new_n <= (std::numeric_limits<size_type>::max() - Alignment) / sizeof(T) &&
+           _padded_bytes(new_n) <= malloc_usable_size(p); // padding has to fit as well
+#else
+    (void)p;
+    return false;
+#endif
+}
+
+#endif // ALIGNED_ALLOCATOR_HPP
@@ -0,0 +1,197 @@
+#ifndef ARENA_ALLOCATOR_HPP
+#define ARENA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+
+class MonotonicArena {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Bump pointer arena. Memory is handed out from big chunks and given back all at once by
+/// reset() or the destructor; deallocate() only rewinds the most recent allocation.
+///
+/// The most recent allocation can grow in place while its chunk has room, which is what
+/// ArenaAllocator::try_expand() relies on: a Vector growing at the top of an arena never
+/// copies its elements.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+public:
+    explicit MonotonicArena(std::size_t chunk_size = 64 * 1024);
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator =(const MonotonicArena&) = delete;
+
+    ~MonotonicArena();
+
+    void* allocate(std::size_t bytes, std::size_t alignment);
+    void deallocate(void* p, std::size_t bytes) noexcept;
+    bool try_expand(void* p, std::size_t old_bytes, std::size_t new_bytes) noexcept;
+
+    void reset() noexcept;                  // Frees everything, keeps the newest chunk for reuse
+    std::size_t used() const noexcept;      // Bytes handed out from the current chunk
+
+private:
+    struct Chunk {
+        Chunk* previous;
+        std::size_t size;                   // Usable bytes following the header
+    };
+
+    static char* _begin(Chunk* chunk) noexcept { return reinterpret_cast<char*>(chunk + 1); }
+    void _add_chunk(std::size_t min_bytes);
+
+    std::size_t _chunk_size;
+    Chunk* _chunk;
+    char* _top;
+    char* _end;
+};
+
+
+template <typename T>
+class ArenaAllocator {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Allocator handle to a MonotonicArena, implements the try_expand extension used by Vector
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    template <typename U>
+    struct rebind { typedef ArenaAllocator<U> other; };
+
+    ArenaAllocator(MonotonicArena& arena) noexcept : _arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& rhs) noexcept : _arena(rhs.arena()) {}
+
+    pointer allocate(size_type n)
+    {
+        if (n > static_cast<size_type>(-1) / sizeof(T))
+            throw std::bad_alloc();
+        return static_cast<pointer>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(pointer p, size_type n) noexcept
+    {
+        _arena->deallocate(p, n * sizeof(T));
+    }
+
+    bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+    {
+        if (new_n > static_cast<size_type>(-1) / sizeof(T))
+            return false;
+        return _arena->try_expand(p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    MonotonicArena* arena() const noexcept { return _arena; }
+
+private:
+    MonotonicArena* _arena;
+};
+
+template <typename T, typename U>
+bool operator ==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.arena() == rhs.arena(); }
+
+template <typename T, typename U>
+bool operator !=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.arena() != rhs.arena(); }
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// MonotonicArena implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+inline MonotonicArena::MonotonicArena(std::size_t chunk_size) :
+    _chunk_size(chunk_size)
+{
+    _chunk = nullptr;
+    _top = nullptr;
+    _end = nullptr;
+}
+
+inline MonotonicArena::~MonotonicArena()
+{
+    while (_chunk) {
+        Chunk* previous = _chunk->previous;
+        std::free(_chunk);
+        _chunk = previous;
+    }
+}
+
+inline void* MonotonicArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (bytes > static_cast<std::size_t>(-1) - alignment)
+        throw std::bad_alloc();
+
+    std::uintptr_t top = reinterpret_cast<std::uintptr_t>(_top);
+    std::uintptr_t aligned = (top + alignment - 1) & ~std::uintptr_t(alignment - 1);
+
+    if (!_top || bytes > std::uintptr_t(_end - _top) || aligned - top > std::uintptr_t(_end - _top) - bytes) {
+        _add_chunk(bytes + alignment);
+        top = reinterpret_cast<std::uintptr_t>(_top);
+        aligned = (top + alignment - 1) & ~std::uintptr_t(alignment - 1);
+    }
+
+    _top = reinterpret_cast<char*>(aligned) + bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+inline void MonotonicArena::deallocate(void* p, std::size_t bytes) noexcept
+{
+    if (static_cast<char*>(p) + bytes == _top)
+        _top = static_cast<char*>(p);
+}
+
+inline bool MonotonicArena::try_expand(void* p, std::size_t old_bytes, std::size_t new_bytes) noexcept
+{
+    char* block = static_cast<char*>(p);
+    if (block + old_bytes != _top || new_bytes > std::size_t(_end - block))
+        return false;
+
+    _top = block + new_bytes;
+    return true;
+}
+
+inline void MonotonicArena::reset() noexcept
+{
+    if (!_chunk)
+        return;
+
+    Chunk* previous = _chunk->previous;
+    while (previous) {
+        Chunk* next = previous->previous;
+        std::free(previous);
+        previous = next;
+    }
+    _chunk->previous = nullptr;
+    _top = _begin(_chunk);
+}
+
+inline std::size_t MonotonicArena::used() const noexcept
+{
+    return _chunk ? _top - _begin(_chunk) : 0;
+}
+
+// Chunks double in size, so an arena serving a growing Vector needs few of them
+inline void MonotonicArena::_add_chunk(std::size_t min_bytes)
+{
+    std::size_t size = _chunk ? 2 * _chunk->size : _chunk_size;
+    if (size < min_bytes)
+        size = min_bytes;
+    if (size > static_cast<std::size_t>(-1) - sizeof(Chunk))
+        throw std::bad_alloc();
+
+    Chunk* chunk = static_cast<Chunk*>(std::malloc(sizeof(Chunk) + size));
+    if (!chunk)
+        throw std::bad_alloc();
+
+    chunk->previous = _chunk;
+    chunk->size = size;
+    _chunk = chunk;
+    _top = _begin(chunk);
+    _end = _top + size;
+}
+
+#endif // ARENA_ALLOCATOR_HPP
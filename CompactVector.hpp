@@ -0,0 +1,51 @@
+#ifndef COMPACT_VECTOR_HPP
+#define COMPACT_VECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "Vector.hpp"
+
+
+template <typename T>
+class CompactAllocator : public VectorAllocator<T> {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// VectorAllocator with a 32-bit size_type. Vector takes size and capacity from the
+/// allocator and stores stateless allocators in no space, so CompactVector<T> is 16 bytes
+/// on 64-bit targets instead of 32 and holds at most 2^32 - 1 bytes worth of elements.
+/// Meant for arrays of small Vectors, e.g. adjacency lists, where density matters.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+public:
+    typedef std::uint32_t size_type;
+
+    template <typename U>
+    struct rebind { typedef CompactAllocator<U> other; };
+
+    CompactAllocator() noexcept {}
+    template <typename U>
+    CompactAllocator(const CompactAllocator<U>&) noexcept {}
+
+    // Extra room beyond what size_type can count is left unused
+    allocation_result<T*, size_type> allocate_at_least(size_type n)
+    {
+        allocation_result<T*, std::size_t> block = VectorAllocator<T>::allocate_at_least(n);
+        allocation_result<T*, size_type> result = { block.ptr, n };
+        if (block.count <= std::numeric_limits<size_type>::max() / sizeof(T))
+            result.count = size_type(block.count);
+        return result;
+    }
+};
+
+template <typename T, typename U>
+bool operator ==(const CompactAllocator<T>&, const CompactAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator !=(const CompactAllocator<T>&, const CompactAllocator<U>&) { return false; }
+
+
+template <typename T, typename G = DefaultGrowth>
+using CompactVector = Vector<T, CompactAllocator<T>, G>;
+
+#endif // COMPACT_VECTOR_HPP
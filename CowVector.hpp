@@ -0,0 +1,500 @@
+#ifndef COW_VECTOR_HPP
+#define COW_VECTOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "Vector.hpp"
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Copy-on-write Vector
+///
+/// Copies of a CowVector share one reference counted Vector, so copying is O(1) whatever the
+/// size. The first mutating call on a CowVector whose buffer is shared gives it a private
+/// copy first; reads never copy. The Vector and its reference count live in one block from
+/// operator new, elements come from A as usual.
+///
+/// Members handing out mutable references or iterators (non-const operator[], begin(),
+/// front(), emplace_back(), mutate(), ...) mark the buffer as leaked: it is never shared
+/// again, since a write through such a reference would show up in every copy. Copying a
+/// CowVector with a leaked buffer is a deep copy, like copying a Vector.
+///
+/// Distinct CowVector objects may be used from different threads, even when they share a
+/// buffer, like distinct std::shared_ptr objects.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cow_detail {
+
+template <typename V>
+struct SharedBuffer {
+    template <typename... Args>
+    SharedBuffer(Args&&... args) : references(1), leaked(false), vector(std::forward<Args>(args)...) {}
+
+    std::atomic<std::size_t> references;
+    bool leaked;                            // Only touched by the single owner
+    V vector;
+};
+
+} // namespace cow_detail
+
+
+template <typename T, typename A = DefaultAllocator<T>, typename G = DefaultGrowth>
+class CowVector {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Vector sharing its buffer between copies until one of them is modified. An empty CowVector
+/// allocates nothing until it is written to or asked for vector(). It keeps its allocator,
+/// so allocators without a default constructor work once passed in.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+public:
+    typedef Vector<T, A, G> vector_type;
+    typedef typename vector_type::allocator_type allocator_type;
+    typedef T value_type;
+    typedef typename vector_type::size_type size_type;
+    typedef typename vector_type::difference_type difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    CowVector() noexcept;
+    explicit CowVector(const A& allocator) noexcept;
+    CowVector(size_type size, const T& init_value, const A& allocator = A());
+    explicit CowVector(const vector_type& vector);
+    explicit CowVector(vector_type&& vector);
+    CowVector(const CowVector& rhs);                // O(1) unless rhs leaked its buffer
+    CowVector(CowVector&& rhs) noexcept;
+
+    ~CowVector();
+
+    const CowVector& operator =(const CowVector& rhs);
+    const CowVector& operator =(CowVector&& rhs) noexcept;
+
+    // Reads, never copy
+    const vector_type& vector() const;            // Allocates an empty CowVector's buffer
+    allocator_type get_allocator() const;
+    const_reference operator [](size_type pos) const;
+    bool empty() const noexcept;
+    size_type size() const noexcept;
+    size_type capacity() const noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+    const_reference front() const;
+    const_reference back() const;
+    bool is_shared() const noexcept;
+
+    // Writes handing out references, detach and leak the buffer
+    vector_type& mutate();
+    reference operator [](size_type pos);
+    iterator begin();
+    iterator end();
+    reference front();
+    reference back();
+    template <typename... Args>
+    reference emplace_back(Args&&... args);
+
+    // Writes, detach when shared. Positions may come from the shared buffer.
+    void push_back(const T& value);
+    void push_back(T&& value);
+    void pop_back();
+    void clear();
+    void reserve(size_type count);
+    void resize(size_type count);
+    void resize(size_type count, const T& value);
+    void assign(size_type count, const T& value);
+    template <typename InputIt, typename = vector_detail::require_iterator<InputIt>>
+    void assign(InputIt first, InputIt last);
+    template <typename InputIt, typename = vector_detail::require_iterator<InputIt>>
+    void append(InputIt first, InputIt last);
+    void insert(const_iterator pos, const T& value);
+    void erase(const_iterator pos);
+    void erase(const_iterator first, const_iterator last);
+    void swap(CowVector& rhs) noexcept;
+
+private:
+    typedef cow_detail::SharedBuffer<vector_type> _buffertype;
+
+    template <typename... Args>
+    static _buffertype* _create(Args&&... args);
+    static void _release(_buffertype* buffer) noexcept;
+
+    vector_type& _writable();
+    vector_type& _leak();
+
+    _buffertype*& _buffer() const noexcept { return _allocatorbuffer.second(); }
+    const A& _allocator() const noexcept { return _allocatorbuffer.first(); }
+
+    // Mutable so that vector() can give an empty CowVector its buffer
+    mutable vector_detail::CompressedPair<A, _buffertype*> _allocatorbuffer;   // Allocator and buffer
+};
+
+template <typename T, typename A, typename G>
+void swap(CowVector<T, A, G>& lhs, CowVector<T, A, G>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// CowVector implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::CowVector() noexcept :
+    _allocatorbuffer(A(), nullptr)
+{
+}
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::CowVector(const A& allocator) noexcept :
+    _allocatorbuffer(allocator, nullptr)
+{
+}
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::CowVector(size_type size, const T& init_value, const A& allocator) :
+    _allocatorbuffer(allocator, nullptr)
+{
+    _buffer() = _create(size, init_value, allocator);
+}
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::CowVector(const vector_type& vector) :
+    _allocatorbuffer(vector.get_allocator(), nullptr)
+{
+    _buffer() = _create(vector);
+}
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::CowVector(vector_type&& vector) :
+    _allocatorbuffer(vector.get_allocator(), nullptr)
+{
+    _buffer() = _create(std::move(vector));
+}
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::CowVector(const CowVector& rhs) :
+    _allocatorbuffer(rhs._allocator(), rhs._buffer())
+{
+    if (!_buffer())
+        return;
+
+    if (_buffer()->leaked)
+        _buffer() = _create(rhs._buffer()->vector);
+    else
+        _buffer()->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::CowVector(CowVector&& rhs) noexcept :
+    _allocatorbuffer(rhs._allocator(), rhs._buffer())
+{
+    rhs._buffer() = nullptr;
+}
+
+template <typename T, typename A, typename G>
+CowVector<T, A, G>::~CowVector()
+{
+    _release(_buffer());
+}
+
+template <typename T, typename A, typename G>
+const CowVector<T, A, G>& CowVector<T, A, G>::operator =(const CowVector& rhs)
+{
+    if (_buffer() != rhs._buffer()) {
+        CowVector copy(rhs);
+        swap(copy);
+    }
+    return *this;
+}
+
+template <typename T, typename A, typename G>
+const CowVector<T, A, G>& CowVector<T, A, G>::operator =(CowVector&& rhs) noexcept
+{
+    if (this != &rhs) {
+        _release(_buffer());
+        _allocatorbuffer.first() = rhs._allocator();
+        _buffer() = rhs._buffer();
+        rhs._buffer() = nullptr;
+    }
+    return *this;
+}
+
+// An empty CowVector may have no buffer yet, it gets an unshared one holding an empty Vector
+template <typename T, typename A, typename G>
+const typename CowVector<T, A, G>::vector_type& CowVector<T, A, G>::vector() const
+{
+    if (!_buffer())
+        _buffer() = _create(_allocator());
+    return _buffer()->vector;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::allocator_type CowVector<T, A, G>::get_allocator() const
+{
+    return _allocator();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::const_reference CowVector<T, A, G>::operator [](size_type pos) const
+{
+    return _buffer()->vector[pos];
+}
+
+template <typename T, typename A, typename G>
+bool CowVector<T, A, G>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::size_type CowVector<T, A, G>::size() const noexcept
+{
+    return _buffer() ? _buffer()->vector.size() : 0;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::size_type CowVector<T, A, G>::capacity() const noexcept
+{
+    return _buffer() ? _buffer()->vector.capacity() : 0;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::const_iterator CowVector<T, A, G>::begin() const noexcept
+{
+    return _buffer() ? _buffer()->vector.cbegin() : nullptr;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::const_iterator CowVector<T, A, G>::end() const noexcept
+{
+    return _buffer() ? _buffer()->vector.cend() : nullptr;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::const_iterator CowVector<T, A, G>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::const_iterator CowVector<T, A, G>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::const_reference CowVector<T, A, G>::front() const
+{
+    return _buffer()->vector.cfront();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::const_reference CowVector<T, A, G>::back() const
+{
+    return _buffer()->vector.cback();
+}
+
+template <typename T, typename A, typename G>
+bool CowVector<T, A, G>::is_shared() const noexcept
+{
+    return _buffer() && _buffer()->references.load(std::memory_order_acquire) != 1;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::vector_type& CowVector<T, A, G>::mutate()
+{
+    return _leak();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::reference CowVector<T, A, G>::operator [](size_type pos)
+{
+    return _leak()[pos];
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::iterator CowVector<T, A, G>::begin()
+{
+    return _leak().begin();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::iterator CowVector<T, A, G>::end()
+{
+    return _leak().end();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::reference CowVector<T, A, G>::front()
+{
+    return _leak().front();
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::reference CowVector<T, A, G>::back()
+{
+    return _leak().back();
+}
+
+template <typename T, typename A, typename G>
+template <typename... Args>
+typename CowVector<T, A, G>::reference CowVector<T, A, G>::emplace_back(Args&&... args)
+{
+    return _leak().emplace_back(std::forward<Args>(args)...);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::push_back(const T& value)
+{
+    _writable().push_back(value);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::push_back(T&& value)
+{
+    _writable().push_back(std::move(value));
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::pop_back()
+{
+    _writable().pop_back();
+}
+
+// A shared buffer is simply let go, there is nothing to copy
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::clear()
+{
+    if (is_shared()) {
+        _release(_buffer());
+        _buffer() = nullptr;
+        return;
+    }
+    if (_buffer())
+        _buffer()->vector.clear();
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::reserve(size_type count)
+{
+    _writable().reserve(count);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::resize(size_type count)
+{
+    _writable().resize(count);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::resize(size_type count, const T& value)
+{
+    _writable().resize(count, value);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::assign(size_type count, const T& value)
+{
+    if (is_shared()) {
+        CowVector(count, value, _allocator()).swap(*this);
+        return;
+    }
+    _writable().assign(count, value);
+}
+
+template <typename T, typename A, typename G>
+template <typename InputIt, typename>
+void CowVector<T, A, G>::assign(InputIt first, InputIt last)
+{
+    if (is_shared()) {
+        vector_type result(_allocator());
+        result.assign(first, last);
+        CowVector(std::move(result)).swap(*this);
+        return;
+    }
+    _writable().assign(first, last);
+}
+
+template <typename T, typename A, typename G>
+template <typename InputIt, typename>
+void CowVector<T, A, G>::append(InputIt first, InputIt last)
+{
+    _writable().append(first, last);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::insert(const_iterator pos, const T& value)
+{
+    size_type offset = pos - cbegin();
+    vector_type& vector = _writable();
+    vector.insert(vector.begin() + offset, value);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::erase(const_iterator pos)
+{
+    erase(pos, pos + 1);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::erase(const_iterator first, const_iterator last)
+{
+    size_type offset = first - cbegin();
+    size_type count = last - first;
+    vector_type& vector = _writable();
+    vector.erase(vector.begin() + offset, vector.begin() + offset + count);
+}
+
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::swap(CowVector& rhs) noexcept
+{
+    using std::swap;
+    swap(_allocatorbuffer.first(), rhs._allocatorbuffer.first());
+    swap(_buffer(), rhs._buffer());
+}
+
+template <typename T, typename A, typename G>
+template <typename... Args>
+typename CowVector<T, A, G>::_buffertype* CowVector<T, A, G>::_create(Args&&... args)
+{
+    return new _buffertype(std::forward<Args>(args)...);
+}
+
+// Last owner destroys the buffer; acq_rel makes all other owners' reads happen before that
+template <typename T, typename A, typename G>
+void CowVector<T, A, G>::_release(_buffertype* buffer) noexcept
+{
+    if (buffer && buffer->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete buffer;
+}
+
+// Returns the Vector, private to this CowVector from now on
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::vector_type& CowVector<T, A, G>::_writable()
+{
+    if (!_buffer()) {
+        _buffer() = _create(_allocator());
+    } else if (is_shared()) {
+        _buffertype* copy = _create(_buffer()->vector);
+        _release(_buffer());
+        _buffer() = copy;
+    }
+    return _buffer()->vector;
+}
+
+template <typename T, typename A, typename G>
+typename CowVector<T, A, G>::vector_type& CowVector<T, A, G>::_leak()
+{
+    vector_type& vector = _writable();
+    _buffer()->leaked = true;
+    return vector;
+}
+
+#endif // COW_VECTOR_HPP
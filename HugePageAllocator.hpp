@@ -0,0 +1,150 @@
+#ifndef HUGE_PAGE_ALLOCATOR_HPP
+#define HUGE_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "Vector.hpp"
+
+
+template <typename T, std::size_t ThresholdBytes = 2 * 1024 * 1024>
+class HugePageAllocator {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Allocator for big lookup tables. Blocks of at least ThresholdBytes are 2 MiB aligned
+/// anonymous mappings, sized in whole 2 MiB pages and marked with MADV_HUGEPAGE, so that
+/// transparent huge pages can back them and random access stops missing the TLB.
+/// Smaller blocks come from malloc.
+///
+/// Implements allocate_at_least (capacity covers the whole huge pages) and try_expand
+/// (mremap in place, which keeps the alignment).
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types need a dedicated allocator");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    template <typename U>
+    struct rebind { typedef HugePageAllocator<U, ThresholdBytes> other; };
+
+    static constexpr size_type huge_page_size = 2 * 1024 * 1024;
+
+    HugePageAllocator() noexcept {}
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, ThresholdBytes>&) noexcept {}
+
+    pointer allocate(size_type n);
+    allocation_result<pointer, size_type> allocate_at_least(size_type n);
+    void deallocate(pointer p, size_type n) noexcept;
+    bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+
+private:
+    static bool _is_huge(size_type n) noexcept { return n >= ThresholdBytes / sizeof(T); }
+    static size_type _huge_bytes(size_type n) noexcept { return vector_detail::mapped_bytes(n, sizeof(T), huge_page_size); }
+};
+
+template <typename T, typename U, std::size_t ThresholdBytes>
+bool operator ==(const HugePageAllocator<T, ThresholdBytes>&, const HugePageAllocator<U, ThresholdBytes>&) { return true; }
+
+template <typename T, typename U, std::size_t ThresholdBytes>
+bool operator !=(const HugePageAllocator<T, ThresholdBytes>&, const HugePageAllocator<U, ThresholdBytes>&) { return false; }
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// HugePageAllocator implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, std::size_t ThresholdBytes>
+constexpr typename HugePageAllocator<T, ThresholdBytes>::size_type HugePageAllocator<T, ThresholdBytes>::huge_page_size;
+
+template <typename T, std::size_t ThresholdBytes>
+typename HugePageAllocator<T, ThresholdBytes>::pointer HugePageAllocator<T, ThresholdBytes>::allocate(size_type n)
+{
+    if (n > (std::numeric_limits<size_type>::max() - 2 * huge_page_size) / sizeof(T))
+        throw std::bad_alloc();
+
+#if defined(__linux__)
+    if (_is_huge(n)) {
+        // Over-map by one huge page, then trim both ends to get a 2 MiB aligned block
+        size_type bytes = _huge_bytes(n);
+        char* mapping = static_cast<char*>(vector_detail::map_block(bytes + huge_page_size));
+
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(mapping);
+        char* aligned = reinterpret_cast<char*>((address + huge_page_size - 1) & ~std::uintptr_t(huge_page_size - 1));
+        if (aligned != mapping)
+            vector_detail::release_block(mapping, aligned - mapping);
+        if (aligned + bytes != mapping + bytes + huge_page_size)
+            vector_detail::release_block(aligned + bytes, mapping + huge_page_size - aligned);
+
+#if defined(MADV_HUGEPAGE)
+        madvise(aligned, bytes, MADV_HUGEPAGE); // only a hint, THP may be disabled
+#endif
+        return reinterpret_cast<pointer>(aligned);
+    }
+#endif
+
+    void* p = std::malloc(n * sizeof(T));
+    if (!p && n)
+        throw std::bad_alloc();
+    return static_cast<pointer>(p);
+}
+
+template <typename T, std::size_t ThresholdBytes>
+allocation_result<typename HugePageAllocator<T, ThresholdBytes>::pointer, typename HugePageAllocator<T, ThresholdBytes>::size_type>
+HugePageAllocator<T, ThresholdBytes>::allocate_at_least(size_type n)
+{
+    allocation_result<pointer, size_type> block = { allocate(n), n };
+#if defined(__linux__)
+    if (_is_huge(n))
+        block.count = _huge_bytes(n) / sizeof(T);
+#endif
+    return block;
+}
+
+template <typename T, std::size_t ThresholdBytes>
+void HugePageAllocator<T, ThresholdBytes>::deallocate(pointer p, size_type n) noexcept
+{
+#if defined(__linux__)
+    if (_is_huge(n)) {
+        vector_detail::release_block(p, _huge_bytes(n));
+        return;
+    }
+#endif
+    std::free(p);
+}
+
+template <typename T, std::size_t ThresholdBytes>
+bool HugePageAllocator<T, ThresholdBytes>::try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+{
+#if defined(__linux__)
+    if (!_is_huge(old_n) || !_is_huge(new_n) || new_n > (std::numeric_limits<size_type>::max() - huge_page_size) / sizeof(T))
+        return false;
+    if (_huge_bytes(new_n) == _huge_bytes(old_n))
+        return true;
+
+    if (!vector_detail::try_expand_block(p, _huge_bytes(old_n), _huge_bytes(new_n)))
+        return false;
+#if defined(MADV_HUGEPAGE)
+    madvise(p, _huge_bytes(new_n), MADV_HUGEPAGE);
+#endif
+    return true;
+#else
+    (void)p;
+    (void)old_n;
+    (void)new_n;
+    return false;
+#endif
+}
+
+#endif // HUGE_PAGE_ALLOCATOR_HPP
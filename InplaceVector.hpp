@@ -0,0 +1,630 @@
+#ifndef INPLACE_VECTOR_HPP
+#define INPLACE_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Vector.hpp"
+
+
+// Mutating members can only be constexpr from C++14 on
+#if __cplusplus >= 201402L
+#define INPLACE_VECTOR_CONSTEXPR constexpr
+#else
+#define INPLACE_VECTOR_CONSTEXPR
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Fixed capacity vector
+///
+/// InplaceVector<T, N> keeps up to N elements inside the object and never allocates.
+/// Going past N throws std::bad_alloc, like running out of memory would.
+///
+/// Whenever T is trivially copyable and trivially destructible, so is InplaceVector<T, N>.
+/// For trivial T the elements are a plain T[N], which also makes InplaceVector usable in
+/// constant expressions (C++14 for mutating members). Constant expressions can't leave the
+/// array uninitialized while runtime code shouldn't pay for zeroing it, so from C++20 on the
+/// array is only zeroed during constant evaluation. Before C++20 a constructor can't tell the
+/// two apart: the default constructor leaves the array alone and isn't constexpr, constant
+/// expressions start from InplaceVector(inplace_constant_init) instead, which zeroes it.
+/// Other types live in raw storage, so they need no default constructor.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+// Selects the constructor which zeroes the elements of trivial types, see above
+struct InplaceConstantInit {};
+constexpr InplaceConstantInit inplace_constant_init{};
+
+namespace inplace_vector_detail {
+
+// Raw storage, element lifetimes are managed by hand
+template <typename T, std::size_t N>
+struct RawStorage {
+    RawStorage() noexcept : size(0) {}
+    explicit RawStorage(InplaceConstantInit) noexcept : size(0) {}
+
+    T* data() noexcept { return reinterpret_cast<T*>(bytes); }
+    const T* data() const noexcept { return reinterpret_cast<const T*>(bytes); }
+
+    template <typename... Args>
+    void construct(std::size_t pos, Args&&... args)
+    {
+        ::new (static_cast<void*>(data() + pos)) T(std::forward<Args>(args)...);
+    }
+    void destroy(std::size_t first, std::size_t last) noexcept
+    {
+        for (; first != last; ++first)
+            data()[first].~T();
+    }
+
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+    std::size_t size;
+};
+
+// Copies, moves and destruction of the elements are written out. Trivially copyable and
+// destructible types get the implicit ones, which copy the bytes, as a partial specialization.
+template <typename T, std::size_t N, bool = std::is_trivial<T>::value,
+          bool = std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value>
+struct Storage : RawStorage<T, N> {
+    using RawStorage<T, N>::data;
+    using RawStorage<T, N>::construct;
+    using RawStorage<T, N>::destroy;
+    using RawStorage<T, N>::size;
+
+    Storage() noexcept {}
+    explicit Storage(InplaceConstantInit) noexcept {}
+    Storage(const Storage& rhs) : RawStorage<T, N>() { _append(rhs.data(), rhs.size); }
+    Storage(Storage&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) :
+        RawStorage<T, N>()
+    {
+        _append(std::make_move_iterator(rhs.data()), rhs.size);
+    }
+
+    Storage& operator =(const Storage& rhs)
+    {
+        if (this != &rhs)
+            _assign(rhs.data(), rhs.size);
+        return *this;
+    }
+    Storage& operator =(Storage&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value &&
+                                                std::is_nothrow_move_assignable<T>::value)
+    {
+        if (this != &rhs)
+            _assign(std::make_move_iterator(rhs.data()), rhs.size);
+        return *this;
+    }
+
+    ~Storage() { destroy(0, size); }
+
+private:
+    template <typename It>
+    void _append(It first, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i, ++first, ++size)
+            construct(size, *first);
+    }
+
+    // Reuses live elements, then constructs or destroys the difference
+    template <typename It>
+    void _assign(It first, std::size_t count)
+    {
+        std::size_t common = count < size ? count : size;
+        for (std::size_t i = 0; i < common; ++i, ++first)
+            data()[i] = *first;
+        if (count < size) {
+            destroy(count, size);
+            size = count;
+        } else {
+            _append(first, count - size);
+        }
+    }
+};
+
+template <typename T, std::size_t N>
+struct Storage<T, N, false, true> : RawStorage<T, N> {
+    Storage() noexcept {}
+    explicit Storage(InplaceConstantInit) noexcept {}
+};
+
+template <typename T, std::size_t N>
+struct Storage<T, N, true, true> {
+#if defined(__cpp_lib_is_constant_evaluated)
+    constexpr Storage() noexcept : size(0)
+    {
+        if (std::is_constant_evaluated()) { // constant expressions can't leave anything uninitialized
+            for (std::size_t i = 0; i < N; ++i)
+                elements[i] = T();
+        }
+    }
+    constexpr explicit Storage(InplaceConstantInit) noexcept : Storage() {}
+#else
+    Storage() noexcept : size(0) {} // not constexpr, a constexpr constructor would have to zero the array
+    constexpr explicit Storage(InplaceConstantInit) noexcept : elements(), size(0) {}
+#endif
+
+    INPLACE_VECTOR_CONSTEXPR T* data() noexcept { return elements; }
+    constexpr const T* data() const noexcept { return elements; }
+
+    template <typename... Args>
+    INPLACE_VECTOR_CONSTEXPR void construct(std::size_t pos, Args&&... args)
+    {
+        elements[pos] = T(std::forward<Args>(args)...);
+    }
+    INPLACE_VECTOR_CONSTEXPR void destroy(std::size_t, std::size_t) noexcept {}
+
+    T elements[N];
+    std::size_t size;
+};
+
+} // namespace inplace_vector_detail
+
+
+template <typename T, std::size_t N>
+class InplaceVector {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Vector with its storage inside the object. Members mirror Vector's, so switching between
+/// the two is a typedef away; capacity is always N and reserve() only checks the bound.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(N > 0, "InplaceVector needs room for at least one element");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    constexpr InplaceVector() noexcept {} // usable in constant expressions from C++20 on
+    constexpr explicit InplaceVector(InplaceConstantInit) noexcept : _storage(inplace_constant_init) {}
+    INPLACE_VECTOR_CONSTEXPR InplaceVector(size_type size, const T& init_value);
+    INPLACE_VECTOR_CONSTEXPR InplaceVector(std::initializer_list<T> values);
+
+    INPLACE_VECTOR_CONSTEXPR reference operator [](size_type pos);
+    constexpr const_reference operator [](size_type pos) const;
+
+    constexpr bool empty() const noexcept;
+    constexpr size_type size() const noexcept;
+    constexpr size_type max_size() const noexcept;
+    constexpr size_type capacity() const noexcept;
+
+    INPLACE_VECTOR_CONSTEXPR iterator begin() noexcept;
+    INPLACE_VECTOR_CONSTEXPR iterator end() noexcept;
+    constexpr const_iterator begin() const noexcept;
+    constexpr const_iterator end() const noexcept;
+    constexpr const_iterator cbegin() const noexcept;
+    constexpr const_iterator cend() const noexcept;
+    reverse_iterator rbegin() noexcept;
+    reverse_iterator rend() noexcept;
+    const_reverse_iterator rbegin() const noexcept;
+    const_reverse_iterator rend() const noexcept;
+    const_reverse_iterator crbegin() const noexcept;
+    const_reverse_iterator crend() const noexcept;
+
+    INPLACE_VECTOR_CONSTEXPR reference front();
+    INPLACE_VECTOR_CONSTEXPR reference back();
+    constexpr const_reference front() const;
+    constexpr const_reference back() const;
+    constexpr const_reference cfront() const;
+    constexpr const_reference cback() const;
+
+    template <typename InputIt, typename = vector_detail::require_iterator<InputIt>>
+    INPLACE_VECTOR_CONSTEXPR void assign(InputIt first, InputIt last);
+    INPLACE_VECTOR_CONSTEXPR void assign(size_type count, const T& value);
+
+    INPLACE_VECTOR_CONSTEXPR void clear() noexcept;
+    INPLACE_VECTOR_CONSTEXPR void shrink_to_fit() noexcept {}
+    INPLACE_VECTOR_CONSTEXPR iterator erase(iterator pos);
+    INPLACE_VECTOR_CONSTEXPR iterator erase(iterator first, iterator last);
+    template <typename Predicate>
+    INPLACE_VECTOR_CONSTEXPR size_type erase_if(Predicate pred);    // Returns number of erased elements
+    INPLACE_VECTOR_CONSTEXPR iterator unordered_erase(iterator pos);  // O(1), last element takes the place of erased one
+    INPLACE_VECTOR_CONSTEXPR void reserve(size_type count);         // Throws std::bad_alloc past N, otherwise no-op
+    INPLACE_VECTOR_CONSTEXPR void resize(size_type count);
+    INPLACE_VECTOR_CONSTEXPR void resize(size_type count, const T& value);
+    INPLACE_VECTOR_CONSTEXPR iterator insert(iterator pos, const T& value);
+    template <typename InputIt, typename = vector_detail::require_iterator<InputIt>>
+    INPLACE_VECTOR_CONSTEXPR void append(InputIt first, InputIt last);
+    template <typename... Args>
+    INPLACE_VECTOR_CONSTEXPR reference emplace_back(Args&&... args);
+    INPLACE_VECTOR_CONSTEXPR void push_back(const T& value);
+    INPLACE_VECTOR_CONSTEXPR void push_back(T&& value);
+
+    // Unchecked variants require capacity() > size(), checked with assert() only
+    template <typename... Args>
+    INPLACE_VECTOR_CONSTEXPR reference emplace_back_unchecked(Args&&... args);
+    INPLACE_VECTOR_CONSTEXPR void push_back_unchecked(const T& value);
+    INPLACE_VECTOR_CONSTEXPR void push_back_unchecked(T&& value);
+
+    INPLACE_VECTOR_CONSTEXPR void pop_back();
+    INPLACE_VECTOR_CONSTEXPR void swap(InplaceVector& rhs);
+
+private:
+    INPLACE_VECTOR_CONSTEXPR void _destroy_tail(size_type new_size) noexcept;
+
+    inplace_vector_detail::Storage<T, N> _storage;
+};
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void swap(InplaceVector<T, N>& lhs, InplaceVector<T, N>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// InplaceVector implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR InplaceVector<T, N>::InplaceVector(size_type size, const T& init_value)
+{
+    assign(size, init_value);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR InplaceVector<T, N>::InplaceVector(std::initializer_list<T> values)
+{
+    append(values.begin(), values.end());
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::reference InplaceVector<T, N>::operator [](size_type pos)
+{
+    return _storage.data()[pos];
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_reference InplaceVector<T, N>::operator [](size_type pos) const
+{
+    return _storage.data()[pos];
+}
+
+template <typename T, std::size_t N>
+constexpr bool InplaceVector<T, N>::empty() const noexcept
+{
+    return _storage.size == 0;
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::size_type InplaceVector<T, N>::size() const noexcept
+{
+    return _storage.size;
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::size_type InplaceVector<T, N>::max_size() const noexcept
+{
+    return N;
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::size_type InplaceVector<T, N>::capacity() const noexcept
+{
+    return N;
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::iterator InplaceVector<T, N>::begin() noexcept
+{
+    return _storage.data();
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::iterator InplaceVector<T, N>::end() noexcept
+{
+    return _storage.data() + _storage.size;
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_iterator InplaceVector<T, N>::begin() const noexcept
+{
+    return _storage.data();
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_iterator InplaceVector<T, N>::end() const noexcept
+{
+    return _storage.data() + _storage.size;
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_iterator InplaceVector<T, N>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_iterator InplaceVector<T, N>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename T, std::size_t N>
+typename InplaceVector<T, N>::reverse_iterator InplaceVector<T, N>::rbegin() noexcept
+{
+    return reverse_iterator(end());
+}
+
+template <typename T, std::size_t N>
+typename InplaceVector<T, N>::reverse_iterator InplaceVector<T, N>::rend() noexcept
+{
+    return reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N>
+typename InplaceVector<T, N>::const_reverse_iterator InplaceVector<T, N>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T, std::size_t N>
+typename InplaceVector<T, N>::const_reverse_iterator InplaceVector<T, N>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N>
+typename InplaceVector<T, N>::const_reverse_iterator InplaceVector<T, N>::crbegin() const noexcept
+{
+    return rbegin();
+}
+
+template <typename T, std::size_t N>
+typename InplaceVector<T, N>::const_reverse_iterator InplaceVector<T, N>::crend() const noexcept
+{
+    return rend();
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::reference InplaceVector<T, N>::front()
+{
+    return _storage.data()[0];
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::reference InplaceVector<T, N>::back()
+{
+    return _storage.data()[_storage.size - 1];
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_reference InplaceVector<T, N>::front() const
+{
+    return _storage.data()[0];
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_reference InplaceVector<T, N>::back() const
+{
+    return _storage.data()[_storage.size - 1];
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_reference InplaceVector<T, N>::cfront() const
+{
+    return front();
+}
+
+template <typename T, std::size_t N>
+constexpr typename InplaceVector<T, N>::const_reference InplaceVector<T, N>::cback() const
+{
+    return back();
+}
+
+template <typename T, std::size_t N>
+template <typename InputIt, typename>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::assign(InputIt first, InputIt last)
+{
+    clear();
+    append(first, last);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::assign(size_type count, const T& value)
+{
+    if (count > N)
+        throw std::bad_alloc();
+
+    T copy(value); // value may be one of the elements
+    clear();
+    for (; _storage.size < count; ++_storage.size)
+        _storage.construct(_storage.size, copy);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::clear() noexcept
+{
+    _destroy_tail(0);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::iterator InplaceVector<T, N>::erase(iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::iterator InplaceVector<T, N>::erase(iterator first, iterator last)
+{
+    if (first == last)
+        return first;
+
+    iterator dest = first;
+    for (iterator it = last; it != end(); ++it, ++dest)
+        *dest = std::move(*it);
+    _destroy_tail(dest - begin());
+    return first;
+}
+
+template <typename T, std::size_t N>
+template <typename Predicate>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::size_type InplaceVector<T, N>::erase_if(Predicate pred)
+{
+    iterator dest = begin();
+    for (iterator it = begin(); it != end(); ++it) {
+        if (pred(*it))
+            continue;
+        if (dest != it)
+            *dest = std::move(*it);
+        ++dest;
+    }
+
+    size_type erased = end() - dest;
+    _destroy_tail(dest - begin());
+    return erased;
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::iterator InplaceVector<T, N>::unordered_erase(iterator pos)
+{
+    if (pos != end() - 1)
+        *pos = std::move(back());
+    pop_back();
+    return pos;
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::reserve(size_type count)
+{
+    if (count > N)
+        throw std::bad_alloc();
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::resize(size_type count)
+{
+    reserve(count);
+    if (count <= _storage.size) {
+        _destroy_tail(count);
+        return;
+    }
+    for (; _storage.size < count; ++_storage.size)
+        _storage.construct(_storage.size);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::resize(size_type count, const T& value)
+{
+    reserve(count);
+    if (count <= _storage.size) {
+        _destroy_tail(count);
+        return;
+    }
+    for (; _storage.size < count; ++_storage.size)
+        _storage.construct(_storage.size, value);
+}
+
+// Elements are shifted right by one, value is copied first since it may be one of them
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::iterator InplaceVector<T, N>::insert(iterator pos, const T& value)
+{
+    if (pos == end()) {
+        push_back(value);
+        return end() - 1;
+    }
+
+    reserve(_storage.size + 1);
+    T copy(value);
+    _storage.construct(_storage.size, std::move(back()));
+    ++_storage.size;
+    for (iterator it = end() - 2; it != pos; --it)
+        *it = std::move(*(it - 1));
+    *pos = std::move(copy);
+    return pos;
+}
+
+template <typename T, std::size_t N>
+template <typename InputIt, typename>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::append(InputIt first, InputIt last)
+{
+    for (; first != last; ++first)
+        emplace_back(*first);
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::reference InplaceVector<T, N>::emplace_back(Args&&... args)
+{
+    if (_storage.size == N)
+        throw std::bad_alloc();
+    return emplace_back_unchecked(std::forward<Args>(args)...);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::push_back(const T& value)
+{
+    emplace_back(value);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::push_back(T&& value)
+{
+    emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+INPLACE_VECTOR_CONSTEXPR typename InplaceVector<T, N>::reference InplaceVector<T, N>::emplace_back_unchecked(Args&&... args)
+{
+    assert(_storage.size < N);
+    _storage.construct(_storage.size, std::forward<Args>(args)...);
+    return _storage.data()[_storage.size++];
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::push_back_unchecked(const T& value)
+{
+    emplace_back_unchecked(value);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::push_back_unchecked(T&& value)
+{
+    emplace_back_unchecked(std::move(value));
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::pop_back()
+{
+    assert(_storage.size > 0);
+    _destroy_tail(_storage.size - 1);
+}
+
+// O(size), elements are exchanged one by one
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::swap(InplaceVector& rhs)
+{
+    InplaceVector& shorter = _storage.size < rhs._storage.size ? *this : rhs;
+    InplaceVector& longer = _storage.size < rhs._storage.size ? rhs : *this;
+
+    size_type common = shorter._storage.size;
+    for (size_type i = 0; i < common; ++i) {
+        T temporary(std::move(shorter[i]));
+        shorter[i] = std::move(longer[i]);
+        longer[i] = std::move(temporary);
+    }
+    for (size_type i = common; i < longer._storage.size; ++i)
+        shorter.emplace_back_unchecked(std::move(longer[i]));
+    longer._destroy_tail(common);
+}
+
+template <typename T, std::size_t N>
+INPLACE_VECTOR_CONSTEXPR void InplaceVector<T, N>::_destroy_tail(size_type new_size) noexcept
+{
+    _storage.destroy(new_size, _storage.size);
+    _storage.size = new_size;
+}
+
+#endif // INPLACE_VECTOR_HPP
@@ -0,0 +1,128 @@
+#ifndef LOCKED_ALLOCATOR_HPP
+#define LOCKED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "Vector.hpp"
+
+
+template <typename T>
+class LockedAllocator {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Allocator for latency critical buffers. Every block is its own anonymous mapping,
+/// populated up front and pinned with mlock(), so neither the first write nor memory
+/// pressure can make an access page fault. Blocks are whole pages: locking works per page,
+/// and a page shared with another block would get unlocked when that block is freed.
+///
+/// allocate() throws std::bad_alloc when the pages can't be locked, typically because
+/// RLIMIT_MEMLOCK is too low. try_expand grows with mremap, which keeps the lock.
+/// On systems without mmap blocks come from malloc and are not locked.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types need a dedicated allocator");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    template <typename U>
+    struct rebind { typedef LockedAllocator<U> other; };
+
+    LockedAllocator() noexcept {}
+    template <typename U>
+    LockedAllocator(const LockedAllocator<U>&) noexcept {}
+
+    pointer allocate(size_type n);
+    allocation_result<pointer, size_type> allocate_at_least(size_type n);
+    void deallocate(pointer p, size_type n) noexcept;
+    bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+
+private:
+    static size_type _locked_bytes(size_type n) noexcept { return vector_detail::mapped_bytes(n, sizeof(T)); }
+};
+
+template <typename T, typename U>
+bool operator ==(const LockedAllocator<T>&, const LockedAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator !=(const LockedAllocator<T>&, const LockedAllocator<U>&) { return false; }
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// LockedAllocator implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+typename LockedAllocator<T>::pointer LockedAllocator<T>::allocate(size_type n)
+{
+    if (n > (std::numeric_limits<size_type>::max() - vector_detail::page_size()) / sizeof(T))
+        throw std::bad_alloc();
+    if (n == 0)
+        n = 1;
+
+#if defined(__linux__)
+    size_type bytes = _locked_bytes(n);
+    void* p = vector_detail::map_block(bytes, MAP_POPULATE);
+    if (mlock(p, bytes) != 0) {
+        vector_detail::release_block(p, bytes);
+        throw std::bad_alloc();
+    }
+    return static_cast<pointer>(p);
+#else
+    void* p = std::malloc(n * sizeof(T));
+    if (!p)
+        throw std::bad_alloc();
+    return static_cast<pointer>(p);
+#endif
+}
+
+template <typename T>
+allocation_result<typename LockedAllocator<T>::pointer, typename LockedAllocator<T>::size_type>
+LockedAllocator<T>::allocate_at_least(size_type n)
+{
+    allocation_result<pointer, size_type> block = { allocate(n), n };
+#if defined(__linux__)
+    block.count = _locked_bytes(n ? n : 1) / sizeof(T);
+#endif
+    return block;
+}
+
+template <typename T>
+void LockedAllocator<T>::deallocate(pointer p, size_type n) noexcept
+{
+#if defined(__linux__)
+    vector_detail::release_block(p, _locked_bytes(n ? n : 1)); // unmapping drops the lock
+#else
+    (void)n;
+    std::free(p);
+#endif
+}
+
+template <typename T>
+bool LockedAllocator<T>::try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+{
+#if defined(__linux__)
+    if (new_n == 0 || new_n > (std::numeric_limits<size_type>::max() - vector_detail::page_size()) / sizeof(T))
+        return false;
+
+    // Fails with EAGAIN when the grown mapping would exceed RLIMIT_MEMLOCK
+    return vector_detail::try_expand_block(p, _locked_bytes(old_n ? old_n : 1), _locked_bytes(new_n));
+#else
+    (void)p;
+    (void)old_n;
+    (void)new_n;
+    return false;
+#endif
+}
+
+#endif // LOCKED_ALLOCATOR_HPP
@@ -0,0 +1,276 @@
+#ifndef NUMA_ALLOCATOR_HPP
+#define NUMA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Vector.hpp"
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// NUMA placement
+///
+/// NumaAllocator places page sized and bigger blocks with mbind(): interleaved over a set
+/// of nodes, bound to them, or left to the kernel's first-touch policy. It talks to the
+/// kernel directly, so there is no libnuma dependency. On single node machines, non-Linux
+/// systems, or when mbind() fails, it silently behaves like a plain mmap allocator.
+///
+/// parallel_append() constructs elements from several threads, so under first-touch each
+/// page lands on the node of the thread which filled it. Threads later processing the
+/// Vector with the same static partitioning then work on local memory.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+enum class NumaPolicy {
+    first_touch,    // Kernel default, page goes to the node of the first thread writing it
+    interleave,     // Pages round-robin over the nodes in the mask
+    bind            // Pages only on the nodes in the mask
+};
+
+namespace numa_detail {
+
+// Number of nodes the kernel reports online, 1 when it can't be determined
+inline unsigned node_count() noexcept
+{
+    static const unsigned count = [] {
+        unsigned last = 0;
+#if defined(__linux__)
+        if (std::FILE* file = std::fopen("/sys/devices/system/node/online", "r")) {
+            unsigned first = 0;
+            char separator = 0;
+            while (std::fscanf(file, "%u%c", &first, &separator) >= 1) {
+                last = first;
+                if (separator == '\n')
+                    break;
+            }
+            std::fclose(file);
+        }
+#endif
+        return last + 1;
+    }();
+    return count;
+}
+
+// Best effort, failures leave the kernel's default placement in effect
+inline void apply_policy(void* p, std::size_t bytes, NumaPolicy policy, unsigned long node_mask) noexcept
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    const int mpol_bind = 2;
+    const int mpol_interleave = 3;
+
+    if (policy == NumaPolicy::first_touch || node_count() < 2)
+        return;
+
+    unsigned long nodes = node_mask;
+    if (node_count() < sizeof(unsigned long) * 8)
+        nodes &= (1UL << node_count()) - 1;
+    if (!nodes)
+        return;
+
+    int mode = policy == NumaPolicy::interleave ? mpol_interleave : mpol_bind;
+    syscall(SYS_mbind, p, bytes, mode, &nodes, sizeof(unsigned long) * 8, 0);
+#else
+    (void)p;
+    (void)bytes;
+    (void)policy;
+    (void)node_mask;
+#endif
+}
+
+} // namespace numa_detail
+
+
+template <typename T>
+class NumaAllocator {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Stateful allocator applying a NumaPolicy to every block of at least one page.
+/// Implements allocate_at_least and try_expand (mremap in place, policy re-applied).
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types need a dedicated allocator");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    template <typename U>
+    struct rebind { typedef NumaAllocator<U> other; };
+
+    // node_mask bit i selects node i, the default selects all nodes
+    NumaAllocator(NumaPolicy policy = NumaPolicy::interleave, unsigned long node_mask = ~0UL) noexcept :
+        _policy(policy), _node_mask(node_mask) {}
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>& rhs) noexcept :
+        _policy(rhs.policy()), _node_mask(rhs.node_mask()) {}
+
+    pointer allocate(size_type n);
+    allocation_result<pointer, size_type> allocate_at_least(size_type n);
+    void deallocate(pointer p, size_type n) noexcept;
+    bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+
+    NumaPolicy policy() const noexcept { return _policy; }
+    unsigned long node_mask() const noexcept { return _node_mask; }
+
+private:
+    // At least a page worth of bytes, rounded up to whole elements so it is never 0
+    static bool _is_mapped(size_type n) noexcept { return n >= (vector_detail::page_size() - 1) / sizeof(T) + 1; }
+    static size_type _mapped_bytes(size_type n) noexcept { return vector_detail::mapped_bytes(n, sizeof(T)); }
+
+    NumaPolicy _policy;
+    unsigned long _node_mask;
+};
+
+template <typename T, typename U>
+bool operator ==(const NumaAllocator<T>&, const NumaAllocator<U>&) { return true; } // Any instance can free any block
+
+template <typename T, typename U>
+bool operator !=(const NumaAllocator<T>&, const NumaAllocator<U>&) { return false; }
+
+
+// Appends count copies of value, constructing them from thread_count threads. Element i is
+// built by thread i * thread_count / count, the same static split a parallel loop uses.
+template <typename T, typename A, typename G>
+void parallel_append(Vector<T, A, G>& vector, typename Vector<T, A, G>::size_type count, const T& value,
+                     unsigned thread_count = std::thread::hardware_concurrency())
+{
+    typedef typename Vector<T, A, G>::size_type size_type;
+
+    if (thread_count == 0)
+        thread_count = 1;
+    if (thread_count > count)
+        thread_count = count ? static_cast<unsigned>(count) : 1;
+
+    A allocator = vector.get_allocator();
+
+    vector.append_with(count, [&](T* dest) {
+        std::vector<std::exception_ptr> errors(thread_count);
+        std::vector<size_type> constructed(thread_count, 0);
+        std::vector<std::thread> threads;
+
+        auto fill = [&](unsigned index) {
+            size_type first = count * index / thread_count;
+            size_type last = count * (index + 1) / thread_count;
+            try {
+                for (size_type i = first; i < last; ++i, ++constructed[index])
+                    std::allocator_traits<A>::construct(allocator, dest + i, value);
+            } catch (...) {
+                errors[index] = std::current_exception();
+            }
+        };
+
+        auto destroy_constructed = [&] {
+            for (unsigned i = 0; i < thread_count; ++i) {
+                T* first = dest + count * i / thread_count;
+                vector_detail::destroy(allocator, first, first + constructed[i]);
+            }
+        };
+
+        try {
+            for (unsigned i = 1; i < thread_count; ++i)
+                threads.emplace_back(fill, i);
+        } catch (...) {
+            // Threads already running use the locals above, they have to finish first
+            for (std::thread& thread : threads)
+                thread.join();
+            destroy_constructed();
+            throw;
+        }
+        fill(0);
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (unsigned i = 0; i < thread_count; ++i) {
+            if (errors[i]) {
+                destroy_constructed();
+                std::rethrow_exception(errors[i]);
+            }
+        }
+    });
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// NumaAllocator implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+typename NumaAllocator<T>::pointer NumaAllocator<T>::allocate(size_type n)
+{
+    if (n > (std::numeric_limits<size_type>::max() - vector_detail::page_size()) / sizeof(T))
+        throw std::bad_alloc();
+
+#if defined(__linux__)
+    if (_is_mapped(n)) {
+        void* p = vector_detail::map_block(_mapped_bytes(n));
+        numa_detail::apply_policy(p, _mapped_bytes(n), _policy, _node_mask);
+        return static_cast<pointer>(p);
+    }
+#endif
+
+    void* p = std::malloc(n * sizeof(T));
+    if (!p && n)
+        throw std::bad_alloc();
+    return static_cast<pointer>(p);
+}
+
+template <typename T>
+allocation_result<typename NumaAllocator<T>::pointer, typename NumaAllocator<T>::size_type>
+NumaAllocator<T>::allocate_at_least(size_type n)
+{
+    allocation_result<pointer, size_type> block = { allocate(n), n };
+#if defined(__linux__)
+    if (_is_mapped(n))
+        block.count = _mapped_bytes(n) / sizeof(T);
+#endif
+    return block;
+}
+
+template <typename T>
+void NumaAllocator<T>::deallocate(pointer p, size_type n) noexcept
+{
+#if defined(__linux__)
+    if (_is_mapped(n)) {
+        vector_detail::release_block(p, _mapped_bytes(n));
+        return;
+    }
+#endif
+    std::free(p);
+}
+
+template <typename T>
+bool NumaAllocator<T>::try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+{
+#if defined(__linux__)
+    if (!_is_mapped(old_n) || !_is_mapped(new_n) ||
+        new_n > (std::numeric_limits<size_type>::max() - vector_detail::page_size()) / sizeof(T))
+        return false;
+    if (_mapped_bytes(new_n) == _mapped_bytes(old_n))
+        return true;
+
+    if (!vector_detail::try_expand_block(p, _mapped_bytes(old_n), _mapped_bytes(new_n)))
+        return false;
+    numa_detail::apply_policy(p, _mapped_bytes(new_n), _policy, _node_mask);
+    return true;
+#else
+    (void)p;
+    (void)old_n;
+    (void)new_n;
+    return false;
+#endif
+}
+
+#endif // NUMA_ALLOCATOR_HPP
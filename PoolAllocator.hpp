@@ -0,0 +1,302 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <new>
+
+#include "Vector.hpp"
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Size class pool
+///
+/// Blocks come in power of two size classes from 16 B to 32 KiB. Each thread keeps its own
+/// free list per class, so allocate/deallocate are a few instructions and take no lock.
+/// Lists exchange blocks with a shared depot in batches: a thread with an empty list takes a
+/// whole batch, a thread whose list grew past two batches (typically one freeing blocks
+/// allocated by other threads) hands one batch back. Exiting threads return everything.
+///
+/// Memory is carved from slabs which are never given back to the system.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace pool_detail {
+
+const std::size_t min_class_shift = 4;                                  // 16 B
+const std::size_t class_count = 12;                                     // up to 32 KiB
+const std::size_t max_class_size = std::size_t(1) << (min_class_shift + class_count - 1);
+const std::size_t batch_size = 32;
+const std::size_t slab_size = 256 * 1024;
+
+struct FreeBlock {
+    FreeBlock* next;
+    FreeBlock* next_batch;                  // Used by the first block of a batch in the depot
+};
+
+inline std::size_t class_index(std::size_t bytes) noexcept
+{
+    std::size_t index = 0;
+    while ((std::size_t(1) << (min_class_shift + index)) < bytes)
+        ++index;
+    return index;
+}
+
+inline std::size_t class_size(std::size_t index) noexcept
+{
+    return std::size_t(1) << (min_class_shift + index);
+}
+
+class Depot {
+public:
+    Depot() noexcept
+    {
+        for (std::size_t i = 0; i < class_count; ++i) {
+            _batches[i] = nullptr;
+            _slab_top[i] = nullptr;
+            _slab_end[i] = nullptr;
+        }
+    }
+
+    // Returns a list of at least one block
+    FreeBlock* take_batch(std::size_t index)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _pop(index);
+    }
+
+    // Returns a single block, for threads whose cache is already gone
+    FreeBlock* take_block(std::size_t index)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        FreeBlock* batch = _pop(index);
+        if (batch->next)
+            _push(index, batch->next);
+        batch->next = nullptr;
+        return batch;
+    }
+
+    void give_batch(std::size_t index, FreeBlock* batch) noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _push(index, batch);
+    }
+
+private:
+    FreeBlock* _pop(std::size_t index)
+    {
+        if (FreeBlock* batch = _batches[index]) {
+            _batches[index] = batch->next_batch;
+            return batch;
+        }
+        return _carve(index);
+    }
+
+    void _push(std::size_t index, FreeBlock* batch) noexcept
+    {
+        batch->next_batch = _batches[index];
+        _batches[index] = batch;
+    }
+
+    FreeBlock* _carve(std::size_t index)
+    {
+        std::size_t size = class_size(index);
+        if (_slab_top[index] == _slab_end[index]) {
+            char* slab = static_cast<char*>(std::malloc(slab_size));
+            if (!slab)
+                throw std::bad_alloc();
+            _slab_top[index] = slab;
+            _slab_end[index] = slab + slab_size / size * size;
+        }
+
+        FreeBlock* first = nullptr;
+        for (std::size_t i = 0; i < batch_size && _slab_top[index] != _slab_end[index]; ++i) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(_slab_top[index]);
+            block->next = first;
+            first = block;
+            _slab_top[index] += size;
+        }
+        return first;
+    }
+
+    std::mutex _mutex;
+    FreeBlock* _batches[class_count];
+    char* _slab_top[class_count];
+    char* _slab_end[class_count];
+};
+
+// Never destroyed, blocks may still be freed while static objects are torn down
+inline Depot& depot()
+{
+    static Depot* instance = new Depot();
+    return *instance;
+}
+
+// Trivially destructible, so it stays usable after the owning thread started exiting
+struct ThreadCache {
+    FreeBlock* lists[class_count];
+    std::size_t counts[class_count];
+    bool registered;
+    bool exited;
+};
+
+inline ThreadCache& thread_cache() noexcept
+{
+    static thread_local ThreadCache cache;
+    return cache;
+}
+
+// Hands all cached blocks back to the depot when its thread exits
+struct ThreadCacheFlusher {
+    ~ThreadCacheFlusher()
+    {
+        ThreadCache& cache = thread_cache();
+        for (std::size_t i = 0; i < class_count; ++i) {
+            if (cache.lists[i])
+                depot().give_batch(i, cache.lists[i]);
+            cache.lists[i] = nullptr;
+            cache.counts[i] = 0;
+        }
+        cache.exited = true;
+    }
+};
+
+// Called by both allocate and deallocate: a thread which only frees blocks allocated
+// elsewhere caches them too, and has to hand them back when it exits
+inline void register_thread_cache(ThreadCache& cache) noexcept
+{
+    static thread_local ThreadCacheFlusher flusher;
+    (void)flusher;
+    cache.registered = true;
+}
+
+// Once the flusher ran, nothing would hand cached blocks back, so both paths bypass the cache
+inline void* allocate(std::size_t index)
+{
+    ThreadCache& cache = thread_cache();
+
+    if (cache.exited)
+        return depot().take_block(index);
+
+    if (!cache.lists[index]) {
+        if (!cache.registered)
+            register_thread_cache(cache);
+
+        FreeBlock* batch = depot().take_batch(index);
+        std::size_t count = 0;
+        for (FreeBlock* block = batch; block; block = block->next)
+            ++count;
+        cache.lists[index] = batch;
+        cache.counts[index] = count;
+    }
+
+    FreeBlock* block = cache.lists[index];
+    cache.lists[index] = block->next;
+    --cache.counts[index];
+    return block;
+}
+
+inline void deallocate(void* p, std::size_t index) noexcept
+{
+    ThreadCache& cache = thread_cache();
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+
+    if (cache.exited) {
+        block->next = nullptr;
+        depot().give_batch(index, block);
+        return;
+    }
+
+    if (!cache.registered)
+        register_thread_cache(cache);
+
+    block->next = cache.lists[index];
+    cache.lists[index] = block;
+
+    if (++cache.counts[index] >= 2 * batch_size) {
+        FreeBlock* last = block;
+        for (std::size_t i = 1; i < batch_size; ++i)
+            last = last->next;
+        cache.lists[index] = last->next;
+        cache.counts[index] -= batch_size;
+        last->next = nullptr;
+        depot().give_batch(index, block);
+    }
+}
+
+} // namespace pool_detail
+
+
+template <typename T>
+class PoolAllocator {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Stateless allocator over the size class pool. Requests above the biggest class go to
+/// malloc. Implements Vector's allocate_at_least and try_expand extensions, so a Vector's
+/// capacity always fills its size class and growth within a class is free.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types need a dedicated allocator");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    template <typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() noexcept {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    pointer allocate(size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            throw std::bad_alloc();
+
+        size_type bytes = n * sizeof(T);
+        if (bytes > pool_detail::max_class_size) {
+            void* p = std::malloc(bytes);
+            if (!p)
+                throw std::bad_alloc();
+            return static_cast<pointer>(p);
+        }
+        return static_cast<pointer>(pool_detail::allocate(pool_detail::class_index(bytes)));
+    }
+
+    allocation_result<pointer, size_type> allocate_at_least(size_type n)
+    {
+        allocation_result<pointer, size_type> block = { allocate(n), n };
+        if (n * sizeof(T) <= pool_detail::max_class_size)
+            block.count = pool_detail::class_size(pool_detail::class_index(n * sizeof(T))) / sizeof(T);
+        return block;
+    }
+
+    void deallocate(pointer p, size_type n) noexcept
+    {
+        size_type bytes = n * sizeof(T);
+        if (bytes > pool_detail::max_class_size)
+            std::free(p);
+        else
+            pool_detail::deallocate(p, pool_detail::class_index(bytes));
+    }
+
+    bool try_expand(pointer, size_type old_n, size_type new_n) noexcept
+    {
+        if (old_n * sizeof(T) > pool_detail::max_class_size || new_n > pool_detail::max_class_size / sizeof(T))
+            return false;
+        return pool_detail::class_index(old_n * sizeof(T)) == pool_detail::class_index(new_n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator ==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator !=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+#endif // POOL_ALLOCATOR_HPP
@@ -0,0 +1,403 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "Vector.hpp"
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Small buffer optimization
+///
+/// SmallVector<T, N> is a Vector whose first N elements live inside the object. The inline
+/// buffer is handed out by SmallBufferAllocator like any other block, so all of Vector's
+/// API and growth logic apply unchanged: a SmallVector spills to the heap allocator when it
+/// outgrows N elements and comes back when shrink_to_fit() finds the buffer big enough.
+///
+/// Moving a SmallVector steals a heap buffer, but inline elements are moved one by one.
+/// Vector is a private base, as Vector's own move would take over the inline buffer.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace small_vector_detail {
+
+template <typename T, std::size_t N>
+struct InlineBuffer {
+    InlineBuffer() noexcept : used(false) {}
+    InlineBuffer(const InlineBuffer&) noexcept : used(false) {}
+    InlineBuffer& operator =(const InlineBuffer&) noexcept { return *this; }
+
+    T* data() noexcept { return reinterpret_cast<T*>(storage); }
+
+    bool used;
+    alignas(T) unsigned char storage[N * sizeof(T)];
+};
+
+} // namespace small_vector_detail
+
+
+template <typename T, std::size_t N, typename A = DefaultAllocator<T>>
+class SmallBufferAllocator {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Serves requests of up to N elements from an inline buffer while it is free, everything
+/// else from A. Forwards try_expand and allocate_at_least to A for heap blocks.
+/// Instances compare equal only when they share both the buffer and equal heap allocators.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(std::is_same<typename std::allocator_traits<A>::pointer, T*>::value,
+                  "heap allocator has to use raw pointers");
+
+public:
+    typedef T value_type;
+    typedef typename std::allocator_traits<A>::size_type size_type;
+    typedef typename std::allocator_traits<A>::difference_type difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+
+    template <typename U>
+    struct rebind {
+        typedef SmallBufferAllocator<U, N, typename std::allocator_traits<A>::template rebind_alloc<U>> other;
+    };
+
+    typedef small_vector_detail::InlineBuffer<T, N> buffer_type;
+
+    SmallBufferAllocator(const A& heap = A(), buffer_type* buffer = nullptr) noexcept :
+        _heap(heap), _buffer(buffer) {}
+    template <typename U, typename B>
+    SmallBufferAllocator(const SmallBufferAllocator<U, N, B>& rhs) noexcept :
+        _heap(rhs.heap()), _buffer(nullptr) {}
+
+    pointer allocate(size_type n)
+    {
+        if (_inline_free(n)) {
+            _buffer->used = true;
+            return _buffer->data();
+        }
+        return std::allocator_traits<A>::allocate(_heap, n);
+    }
+
+    allocation_result<pointer, size_type> allocate_at_least(size_type n)
+    {
+        if (_inline_free(n)) {
+            _buffer->used = true;
+            allocation_result<pointer, size_type> block = { _buffer->data(), N };
+            return block;
+        }
+        return vector_detail::allocate_at_least(_heap, n);
+    }
+
+    void deallocate(pointer p, size_type n) noexcept
+    {
+        if (is_inline(p))
+            _buffer->used = false;
+        else
+            std::allocator_traits<A>::deallocate(_heap, p, n);
+    }
+
+    // A heap block shrinking to fit the free inline buffer is moved there instead
+    bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+    {
+        if (is_inline(p))
+            return new_n <= N;
+        if (_inline_free(new_n))
+            return false;
+        return vector_detail::try_expand(_heap, p, old_n, new_n);
+    }
+
+    SmallBufferAllocator select_on_container_copy_construction() const
+    {
+        return SmallBufferAllocator(std::allocator_traits<A>::select_on_container_copy_construction(_heap));
+    }
+
+    bool is_inline(const T* p) const noexcept { return _buffer && p == _buffer->data(); }
+    const A& heap() const noexcept { return _heap; }
+    buffer_type* buffer() const noexcept { return _buffer; }
+
+private:
+    bool _inline_free(size_type n) const noexcept { return _buffer && !_buffer->used && n <= N; }
+
+    A _heap;
+    buffer_type* _buffer;
+};
+
+template <typename T, typename U, std::size_t N, typename A, typename B>
+bool operator ==(const SmallBufferAllocator<T, N, A>& lhs, const SmallBufferAllocator<U, N, B>& rhs)
+{
+    return static_cast<const void*>(lhs.buffer()) == static_cast<const void*>(rhs.buffer()) && lhs.heap() == rhs.heap();
+}
+
+template <typename T, typename U, std::size_t N, typename A, typename B>
+bool operator !=(const SmallBufferAllocator<T, N, A>& lhs, const SmallBufferAllocator<U, N, B>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+
+template <typename T, std::size_t N, typename A = DefaultAllocator<T>, typename G = DefaultGrowth>
+class SmallVector : private small_vector_detail::InlineBuffer<T, N>,
+                    private Vector<T, SmallBufferAllocator<T, N, A>, G> {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Vector with inline room for N elements, no allocation happens until it holds more.
+/// The buffer is a base class, so it is constructed before and destroyed after the Vector
+/// using it.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+    static_assert(N > 0, "SmallVector needs room for at least one inline element");
+
+    typedef small_vector_detail::InlineBuffer<T, N> _buffertype;
+    typedef Vector<T, SmallBufferAllocator<T, N, A>, G> _vectortype;
+
+public:
+    typedef typename _vectortype::allocator_type allocator_type;
+    typedef typename _vectortype::value_type value_type;
+    typedef typename _vectortype::size_type size_type;
+    typedef typename _vectortype::reference reference;
+    typedef typename _vectortype::pointer pointer;
+    typedef typename _vectortype::const_reference const_reference;
+    typedef typename _vectortype::difference_type difference_type;
+    typedef typename _vectortype::iterator iterator;
+    typedef typename _vectortype::const_iterator const_iterator;
+    typedef typename _vectortype::reverse_iterator reverse_iterator;
+    typedef typename _vectortype::const_reverse_iterator const_reverse_iterator;
+
+    static constexpr size_type inline_capacity = N;
+
+    SmallVector();
+    explicit SmallVector(const A& allocator);
+    SmallVector(size_type size, const A& allocator = A());         // Reserves, like Vector(size_type)
+    SmallVector(size_type size, const T& init_value, const A& allocator = A());
+    SmallVector(const SmallVector& rhs);
+    SmallVector(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    const SmallVector& operator =(const SmallVector& rhs);
+    const SmallVector& operator =(SmallVector&& rhs);
+
+    // Element-wise, two SmallVectors never share a buffer
+    bool operator ==(const SmallVector& rhs) const
+    {
+        return size() == rhs.size() && std::equal(begin(), end(), rhs.begin());
+    }
+    bool operator !=(const SmallVector& rhs) const { return !(*this == rhs); }
+    bool operator <(const SmallVector& rhs) const
+    {
+        return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
+    }
+    bool operator <=(const SmallVector& rhs) const { return !(rhs < *this); }
+    bool operator >(const SmallVector& rhs) const { return rhs < *this; }
+    bool operator >=(const SmallVector& rhs) const { return !(*this < rhs); }
+
+    using _vectortype::get_allocator;
+    using _vectortype::operator [];
+    using _vectortype::empty;
+    using _vectortype::size;
+    using _vectortype::max_size;
+    using _vectortype::capacity;
+    using _vectortype::begin;
+    using _vectortype::end;
+    using _vectortype::cbegin;
+    using _vectortype::cend;
+    using _vectortype::rbegin;
+    using _vectortype::rend;
+    using _vectortype::crbegin;
+    using _vectortype::crend;
+    using _vectortype::front;
+    using _vectortype::back;
+    using _vectortype::cfront;
+    using _vectortype::cback;
+    using _vectortype::assign;
+    using _vectortype::clear;
+    using _vectortype::erase;
+    using _vectortype::erase_if;
+    using _vectortype::unordered_erase;
+    using _vectortype::insert_many;
+    using _vectortype::erase_many;
+    using _vectortype::reserve;
+    using _vectortype::reserve_populated;
+    using _vectortype::resize;
+    using _vectortype::resize_default_init;
+    using _vectortype::resize_uninitialized;
+    using _vectortype::append_with;
+    using _vectortype::insert;
+    using _vectortype::append;
+    using _vectortype::emplace_back;
+    using _vectortype::push_back;
+    using _vectortype::emplace_back_unchecked;
+    using _vectortype::push_back_unchecked;
+    using _vectortype::pop_back;
+
+    bool is_inline() const noexcept { return this->_data_array() == _inline_data(); }
+
+    void shrink_to_fit();
+    void release_memory() noexcept;    // Frees the heap buffer, inline capacity stays available
+    void swap(SmallVector& rhs);
+
+private:
+    T* _inline_data() const noexcept { return const_cast<_buffertype*>(static_cast<const _buffertype*>(this))->data(); }
+
+    void _attach_inline() noexcept;
+    bool _can_steal(const SmallVector& rhs) const noexcept;
+    void _steal(SmallVector& rhs) noexcept;
+};
+
+template <typename T, std::size_t N, typename A, typename G>
+void swap(SmallVector<T, N, A, G>& lhs, SmallVector<T, N, A, G>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// SmallVector implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, std::size_t N, typename A, typename G>
+constexpr typename SmallVector<T, N, A, G>::size_type SmallVector<T, N, A, G>::inline_capacity;
+
+template <typename T, std::size_t N, typename A, typename G>
+SmallVector<T, N, A, G>::SmallVector() :
+    _vectortype(SmallBufferAllocator<T, N, A>(A(), static_cast<_buffertype*>(this)))
+{
+    _attach_inline();
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+SmallVector<T, N, A, G>::SmallVector(const A& allocator) :
+    _vectortype(SmallBufferAllocator<T, N, A>(allocator, static_cast<_buffertype*>(this)))
+{
+    _attach_inline();
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+SmallVector<T, N, A, G>::SmallVector(size_type size, const A& allocator) :
+    _vectortype(size, SmallBufferAllocator<T, N, A>(allocator, static_cast<_buffertype*>(this)))
+{
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+SmallVector<T, N, A, G>::SmallVector(size_type size, const T& init_value, const A& allocator) :
+    _vectortype(SmallBufferAllocator<T, N, A>(allocator, static_cast<_buffertype*>(this)))
+{
+    _attach_inline();
+    this->assign(size, init_value);
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+SmallVector<T, N, A, G>::SmallVector(const SmallVector& rhs) :
+    _buffertype(),
+    _vectortype(SmallBufferAllocator<T, N, A>(
+        std::allocator_traits<A>::select_on_container_copy_construction(rhs.get_allocator().heap()), static_cast<_buffertype*>(this)))
+{
+    _attach_inline();
+    this->assign(rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+SmallVector<T, N, A, G>::SmallVector(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) :
+    _buffertype(),
+    _vectortype(SmallBufferAllocator<T, N, A>(rhs.get_allocator().heap(), static_cast<_buffertype*>(this)))
+{
+    if (_can_steal(rhs)) {
+        _steal(rhs);
+        return;
+    }
+
+    // Heap allocators are copies and compare equal, so only inline elements get here and
+    // they fit the inline buffer
+    _attach_inline();
+    for (T& value : rhs)
+        this->emplace_back_unchecked(std::move(value));
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+const SmallVector<T, N, A, G>& SmallVector<T, N, A, G>::operator =(const SmallVector& rhs)
+{
+    if (this != &rhs)
+        this->assign(rhs.begin(), rhs.end());
+    return *this;
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+const SmallVector<T, N, A, G>& SmallVector<T, N, A, G>::operator =(SmallVector&& rhs)
+{
+    if (this == &rhs)
+        return *this;
+
+    if (_can_steal(rhs)) {
+        this->_deallocate();
+        _steal(rhs);
+    } else {
+        this->assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+void SmallVector<T, N, A, G>::shrink_to_fit()
+{
+    _vectortype::shrink_to_fit();
+    _attach_inline();
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+void SmallVector<T, N, A, G>::release_memory() noexcept
+{
+    _vectortype::release_memory();
+    _attach_inline();
+}
+
+// Exchanges heap buffers when both have one, otherwise goes through a temporary
+template <typename T, std::size_t N, typename A, typename G>
+void SmallVector<T, N, A, G>::swap(SmallVector& rhs)
+{
+    if (this == &rhs)
+        return;
+
+    if (!is_inline() && !rhs.is_inline() && this->_data_array() && rhs._data_array() &&
+        this->get_allocator().heap() == rhs.get_allocator().heap()) {
+        std::swap(this->_size, rhs._size);
+        std::swap(this->_capacity, rhs._capacity);
+        std::swap(this->_data_array(), rhs._data_array());
+        return;
+    }
+
+    SmallVector temporary(std::move(rhs));
+    rhs = std::move(*this);
+    *this = std::move(temporary);
+}
+
+// Gives an empty, unallocated SmallVector its inline capacity, can't fail
+template <typename T, std::size_t N, typename A, typename G>
+void SmallVector<T, N, A, G>::_attach_inline() noexcept
+{
+    if (!this->_data_array()) {
+        _buffertype::used = true;
+        this->_data_array() = _inline_data();
+        this->_capacity = N;
+    }
+}
+
+template <typename T, std::size_t N, typename A, typename G>
+bool SmallVector<T, N, A, G>::_can_steal(const SmallVector& rhs) const noexcept
+{
+    return rhs._data_array() && !rhs.is_inline() && this->get_allocator().heap() == rhs.get_allocator().heap();
+}
+
+// Takes over rhs heap buffer, this must not own any memory. rhs falls back to its inline buffer.
+template <typename T, std::size_t N, typename A, typename G>
+void SmallVector<T, N, A, G>::_steal(SmallVector& rhs) noexcept
+{
+    this->_size = rhs._size;
+    this->_capacity = rhs._capacity;
+    this->_data_array() = rhs._data_array();
+
+    rhs._size = 0;
+    rhs._capacity = 0;
+    rhs._data_array() = nullptr;
+    rhs._attach_inline();
+}
+
+#endif // SMALL_VECTOR_HPP
@@ -1,54 +1,632 @@
 #ifndef VECTOR_HPP
 #define VECTOR_HPP
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iterator>
 #include <initializer_list>
 #include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <iostream>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 
-// TO DO: add r-value reference support
 // DO DO: re-write iterator classes in DRY way
 
 
-template <typename T, typename A = std::allocator<T>>
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Relocation traits
+///
+/// A type is trivially relocatable when moving an object to a new address and forgetting
+/// the old one is equivalent to copying its bytes. Every trivially copyable type qualifies;
+/// other types (e.g. ones holding only owning pointers) may opt in by specializing:
+///
+///     template <> struct is_trivially_relocatable<MyType> : std::true_type {};
+///
+/// Types which store pointers into themselves must never be marked as relocatable.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+
+// Mirror of C++23 std::allocation_result
+template <typename Pointer, typename SizeType = std::size_t>
+struct allocation_result {
+    Pointer ptr;
+    SizeType count;
+};
+
+
+namespace vector_detail {
+
+template <typename It>
+using require_iterator = typename std::iterator_traits<It>::iterator_category;
+
+// Only plain pointers to the element type can point into a Vector's buffer
+template <typename It, typename T>
+struct is_element_pointer : std::integral_constant<bool, std::is_pointer<It>::value &&
+                                                         std::is_same<typename std::remove_cv<typename std::remove_pointer<It>::type>::type, T>::value> {};
+
+template <typename Writer, typename P, typename S>
+S call_writer(Writer& writer, P dest, S count, std::true_type)
+{
+    writer(dest);
+    return count;
+}
+
+template <typename Writer, typename P, typename S>
+S call_writer(Writer& writer, P dest, S, std::false_type)
+{
+    return writer(dest);
+}
+
+template <typename A>
+void copy_allocator(A& lhs, const A& rhs, std::true_type)
+{
+    lhs = rhs;
+}
+
+template <typename A>
+void copy_allocator(A&, const A&, std::false_type)
+{
+}
+
+template <typename A>
+void move_allocator(A& lhs, A& rhs, std::true_type)
+{
+    lhs = std::move(rhs);
+}
+
+template <typename A>
+void move_allocator(A&, A&, std::false_type)
+{
+}
+
+template <typename A>
+void swap_allocators(A& lhs, A& rhs, std::true_type)
+{
+    using std::swap;
+    swap(lhs, rhs);
+}
+
+template <typename A>
+void swap_allocators(A&, A&, std::false_type)
+{
+}
+
+#if __cplusplus >= 201402L
+template <typename A>
+struct is_final : std::is_final<A> {};
+#else
+template <typename A>
+struct is_final : std::integral_constant<bool, __is_final(A)> {};
+#endif
+
+// Pair whose first member takes no room when it is an empty class, thanks to the empty base
+// optimization. Vector keeps its allocator in one, so stateless allocators cost nothing.
+template <typename First, typename Second, bool = std::is_empty<First>::value && !is_final<First>::value>
+class CompressedPair {
+public:
+    CompressedPair(const First& first, const Second& second) : _first(first), _second(second) {}
+    CompressedPair(First&& first, const Second& second) : _first(std::move(first)), _second(second) {}
+
+    First& first() noexcept { return _first; }
+    const First& first() const noexcept { return _first; }
+    Second& second() noexcept { return _second; }
+    const Second& second() const noexcept { return _second; }
+
+private:
+    First _first;
+    Second _second;
+};
+
+template <typename First, typename Second>
+class CompressedPair<First, Second, true> : private First {
+public:
+    CompressedPair(const First& first, const Second& second) : First(first), _second(second) {}
+    CompressedPair(First&& first, const Second& second) : First(std::move(first)), _second(second) {}
+
+    First& first() noexcept { return *this; }
+    const First& first() const noexcept { return *this; }
+    Second& second() noexcept { return _second; }
+    const Second& second() const noexcept { return _second; }
+
+private:
+    Second _second;
+};
+
+// Returns how many elements a writer produced: its result, or count when it returns void
+template <typename Writer, typename P, typename S>
+S call_writer(Writer& writer, P dest, S count)
+{
+    return call_writer(writer, dest, count, std::is_void<decltype(writer(dest))>());
+}
+
+template <typename A, typename T>
+void destroy(A& allocator, T* first, T* last)
+{
+    for (; first != last; ++first)
+        std::allocator_traits<A>::destroy(allocator, first);
+}
+
+template <typename A, typename T>
+T* uninitialized_copy(A&, const T* first, const T* last, T* dest, std::true_type)
+{
+    if (first != last)
+        std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+    return dest + (last - first);
+}
+
+template <typename A, typename InputIt, typename T>
+T* uninitialized_copy(A& allocator, InputIt first, InputIt last, T* dest, std::false_type)
+{
+    T* current = dest;
+    try {
+        for (; first != last; ++first, ++current)
+            std::allocator_traits<A>::construct(allocator, current, *first);
+    } catch (...) {
+        destroy(allocator, dest, current);
+        throw;
+    }
+    return current;
+}
+
+// Copy constructs [first, last) into raw memory at dest, a single memcpy for trivial types.
+// Returns the end of the constructed range.
+template <typename A, typename InputIt, typename T>
+T* uninitialized_copy(A& allocator, InputIt first, InputIt last, T* dest)
+{
+    typedef typename std::remove_cv<typename std::iterator_traits<InputIt>::value_type>::type source_type;
+    return uninitialized_copy(allocator, first, last, dest,
+                              std::integral_constant<bool, std::is_pointer<InputIt>::value &&
+                                                           std::is_same<source_type, T>::value &&
+                                                           std::is_trivially_copyable<T>::value>());
+}
+
+// Whole buffer is moved with a single memcpy, source objects are not destroyed
+template <typename A, typename T>
+void relocate(A&, T* first, T* last, T* dest, std::true_type)
+{
+    if (first != last)
+        std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+}
+
+// Element by element move (or copy when move may throw), then source objects are destroyed.
+// If a copy throws, already constructed elements are destroyed and source stays untouched.
+template <typename A, typename T>
+void relocate(A& allocator, T* first, T* last, T* dest, std::false_type)
+{
+    T* current = dest;
+    try {
+        for (T* it = first; it != last; ++it, ++current)
+            std::allocator_traits<A>::construct(allocator, current, std::move_if_noexcept(*it));
+    } catch (...) {
+        destroy(allocator, dest, current);
+        throw;
+    }
+    destroy(allocator, first, last);
+}
+
+// Moves [first, last) into raw memory at dest, leaving [first, last) as raw memory
+template <typename A, typename T>
+void relocate(A& allocator, T* first, T* last, T* dest)
+{
+    relocate(allocator, first, last, dest, is_trivially_relocatable<T>());
+}
+
+
+// Optional allocator extensions, detected at compile time:
+//
+//   bool try_expand(pointer p, size_type old_n, size_type new_n);
+//       Resizes the block in place, never moves it. Returns false when impossible.
+//
+//   pointer reallocate(pointer p, size_type old_n, size_type new_n);
+//       realloc() semantics: the block may move and its bytes are carried over.
+//       Vector uses this only for trivially relocatable types.
+//
+//   allocation_result<pointer> allocate_at_least(size_type n);
+//       Like C++23 std::allocator::allocate_at_least: returns the block together with the
+//       number of elements which really fit in it. Any count between n and the returned one
+//       may later be passed to deallocate().
+
+template <typename A, typename = void>
+struct has_try_expand : std::false_type {};
+
+template <typename A>
+struct has_try_expand<A, decltype(void(std::declval<A&>().try_expand(
+        std::declval<typename std::allocator_traits<A>::pointer>(),
+        std::declval<typename std::allocator_traits<A>::size_type>(),
+        std::declval<typename std::allocator_traits<A>::size_type>())))> : std::true_type {};
+
+template <typename A, typename = void>
+struct has_reallocate : std::false_type {};
+
+template <typename A>
+struct has_reallocate<A, decltype(void(std::declval<A&>().reallocate(
+        std::declval<typename std::allocator_traits<A>::pointer>(),
+        std::declval<typename std::allocator_traits<A>::size_type>(),
+        std::declval<typename std::allocator_traits<A>::size_type>())))> : std::true_type {};
+
+template <typename A, typename P, typename S>
+bool try_expand(A& allocator, P p, S old_n, S new_n, std::true_type)
+{
+    return allocator.try_expand(p, old_n, new_n);
+}
+
+template <typename A, typename P, typename S>
+bool try_expand(A&, P, S, S, std::false_type)
+{
+    return false;
+}
+
+template <typename A, typename P, typename S>
+bool try_expand(A& allocator, P p, S old_n, S new_n)
+{
+    return try_expand(allocator, p, old_n, new_n, has_try_expand<A>());
+}
+
+template <typename A, typename P, typename S>
+bool reallocate(A& allocator, P& p, S old_n, S new_n, std::true_type)
+{
+    p = allocator.reallocate(p, old_n, new_n);
+    return true;
+}
+
+template <typename A, typename P, typename S>
+bool reallocate(A&, P&, S, S, std::false_type)
+{
+    return false;
+}
+
+// Returns false when the block has to be moved by the caller instead
+template <typename A, typename P, typename S>
+bool reallocate(A& allocator, P& p, S old_n, S new_n)
+{
+    typedef typename std::allocator_traits<A>::value_type value_type;
+    return reallocate(allocator, p, old_n, new_n,
+                      std::integral_constant<bool, has_reallocate<A>::value &&
+                                                   is_trivially_relocatable<value_type>::value>());
+}
+
+template <typename A, typename = void>
+struct has_allocate_at_least : std::false_type {};
+
+template <typename A>
+struct has_allocate_at_least<A, decltype(void(std::declval<A&>().allocate_at_least(
+        std::declval<typename std::allocator_traits<A>::size_type>()).count))> : std::true_type {};
+
+template <typename A, typename S>
+allocation_result<typename std::allocator_traits<A>::pointer, S> allocate_at_least(A& allocator, S n, std::true_type)
+{
+    auto result = allocator.allocate_at_least(n);
+    allocation_result<typename std::allocator_traits<A>::pointer, S> block = { result.ptr, S(result.count) };
+    return block;
+}
+
+template <typename A, typename S>
+allocation_result<typename std::allocator_traits<A>::pointer, S> allocate_at_least(A& allocator, S n, std::false_type)
+{
+    allocation_result<typename std::allocator_traits<A>::pointer, S> block = { std::allocator_traits<A>::allocate(allocator, n), n };
+    return block;
+}
+
+// Allocates room for at least n elements and reports how many really fit
+template <typename A, typename S>
+allocation_result<typename std::allocator_traits<A>::pointer, S> allocate_at_least(A& allocator, S n)
+{
+    return allocate_at_least(allocator, n, has_allocate_at_least<A>());
+}
+
+inline std::size_t page_size() noexcept
+{
+#if defined(__linux__)
+    static const std::size_t size = sysconf(_SC_PAGESIZE);
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+// Bytes of a mapping holding n elements, rounded up to whole granules (pages by default)
+inline std::size_t mapped_bytes(std::size_t n, std::size_t element_size, std::size_t granule = page_size()) noexcept
+{
+    return (n * element_size + granule - 1) / granule * granule;
+}
+
+#if defined(__linux__)
+// Mapped blocks, shared by the allocators which take whole pages straight from the kernel.
+// Sizes must be multiples of the page size.
+
+inline void* map_block(std::size_t bytes, int flags = 0)
+{
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    if (p == MAP_FAILED)
+        throw std::bad_alloc();
+    return p;
+}
+
+inline void release_block(void* p, std::size_t bytes) noexcept
+{
+    munmap(p, bytes);
+}
+
+// Resizes the mapping without moving it, fails when the pages past it are taken
+inline bool try_expand_block(void* p, std::size_t old_bytes, std::size_t new_bytes) noexcept
+{
+    return old_bytes == new_bytes || mremap(p, old_bytes, new_bytes, 0) != MAP_FAILED;
+}
+#endif
+
+// Makes the kernel back [p, p + bytes) with physical pages now, so the first write to
+// them doesn't page fault. The bytes must be raw storage owned by the caller.
+inline void prefault(void* p, std::size_t bytes) noexcept
+{
+    if (!bytes)
+        return;
+
+    char* first = static_cast<char*>(p);
+    char* last = first + bytes;
+    std::size_t page = page_size();
+#if defined(MADV_POPULATE_WRITE)
+    // Linux 5.14+, populates without touching the contents
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(first) & ~std::uintptr_t(page - 1);
+    if (madvise(reinterpret_cast<void*>(begin), reinterpret_cast<std::uintptr_t>(last) - begin, MADV_POPULATE_WRITE) == 0)
+        return;
+#endif
+    for (char* it = first; it < last; it += page)
+        *static_cast<volatile char*>(it) = 0;
+    *static_cast<volatile char*>(last - 1) = 0;
+}
+
+} // namespace vector_detail
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Default Vector allocator
+///
+/// Stateless malloc based allocator. Unlike std::allocator it implements the try_expand and
+/// reallocate extensions, so Vector of trivially relocatable types grows with realloc().
+///
+/// On Linux blocks of at least mmap_threshold bytes are anonymous mappings which grow with
+/// mremap(): the kernel moves page table entries instead of copying data, so doubling a
+/// multi-GB buffer costs about as much as doubling a small one.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class VectorAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types need a dedicated allocator");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+
+    template <typename U>
+    struct rebind { typedef VectorAllocator<U> other; };
+
+    VectorAllocator() noexcept {}
+    template <typename U>
+    VectorAllocator(const VectorAllocator<U>&) noexcept {}
+
+    pointer allocate(size_type n);
+    allocation_result<pointer, size_type> allocate_at_least(size_type n);
+    void deallocate(pointer p, size_type n) noexcept;
+
+    bool try_expand(pointer p, size_type old_n, size_type new_n) noexcept;
+    pointer reallocate(pointer p, size_type old_n, size_type new_n);
+
+#if defined(__linux__)
+    static constexpr size_type mmap_threshold = 1024 * 1024; // bytes
+#else
+    static constexpr size_type mmap_threshold = std::numeric_limits<size_type>::max();
+#endif
+
+private:
+    static size_type _bytes(size_type n);
+    // Fewest elements taking at least mmap_threshold bytes, n * sizeof(T) >= mmap_threshold
+    // without the overflow. Always at least 1, so empty blocks are never mapped.
+    static size_type _first_mapped() noexcept { return (mmap_threshold - 1) / sizeof(T) + 1; }
+    static bool _is_mapped(size_type n) noexcept { return n >= _first_mapped(); }
+    static size_type _mapped_bytes(size_type n) noexcept { return vector_detail::mapped_bytes(n, sizeof(T)); }
+};
+
+template <typename T, typename U>
+bool operator ==(const VectorAllocator<T>&, const VectorAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator !=(const VectorAllocator<T>&, const VectorAllocator<U>&) { return false; }
+
+template <typename T, std::size_t Alignment>
+class AlignedAllocator; // AlignedAllocator.hpp, included at the end of this file
+
+// Vector's default allocator. VectorAllocator hands out malloc aligned blocks, so over-aligned
+// types get AlignedAllocator instead; std::allocator only honours alignof(T) from C++17 on.
+template <typename T>
+using DefaultAllocator = typename std::conditional<(alignof(T) > alignof(std::max_align_t)),
+                                                   AlignedAllocator<T, alignof(T)>, VectorAllocator<T>>::type;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Growth policies
+///
+/// A policy decides the capacity Vector grows to once it runs out of space:
+///
+///     static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t element_size);
+///
+/// The result must be at least 'required'. Element size is passed so policies can think in
+/// bytes rather than in elements.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace vector_detail {
+
+inline std::size_t scale_capacity(std::size_t capacity, std::size_t num, std::size_t den)
+{
+    if (capacity > std::numeric_limits<std::size_t>::max() / num)
+        return std::numeric_limits<std::size_t>::max();
+    return capacity * num / den;
+}
+
+inline std::size_t at_least(std::size_t capacity, std::size_t required)
+{
+    return capacity > required ? capacity : required;
+}
+
+} // namespace vector_detail
+
+// capacity * Num / Den
+template <std::size_t Num, std::size_t Den>
+struct GeometricGrowth {
+    static_assert(Num > Den, "growth factor must be greater than 1");
+
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t)
+    {
+        std::size_t grown = vector_detail::scale_capacity(capacity, Num, Den);
+        return vector_detail::at_least(grown > capacity ? grown : capacity + 1, required);
+    }
+};
+
+typedef GeometricGrowth<2, 1> DoublingGrowth;
+typedef GeometricGrowth<3, 2> OneAndHalfGrowth;
+
+// Capacities follow the Fibonacci sequence, so freed blocks can be reused by later growth
+struct FibonacciGrowth {
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t)
+    {
+        std::size_t previous = 1, current = 1;
+        while (current <= capacity && current <= std::numeric_limits<std::size_t>::max() - previous) {
+            std::size_t next = previous + current;
+            previous = current;
+            current = next;
+        }
+        return vector_detail::at_least(current > capacity ? current : capacity + 1, required);
+    }
+};
+
+// Doubles byte size rounded to a power of two up to a page, then to whole pages,
+// so every allocation fills a malloc size class or a page completely
+struct SizeClassGrowth {
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t element_size)
+    {
+        const std::size_t page_size = 4096;
+        std::size_t count = vector_detail::at_least(vector_detail::scale_capacity(capacity, 2, 1), required);
+        if (count > std::numeric_limits<std::size_t>::max() / element_size - page_size)
+            return count;
+
+        std::size_t bytes = count * element_size;
+        if (bytes < page_size) {
+            std::size_t size_class = 16;
+            while (size_class < bytes)
+                size_class *= 2;
+            bytes = size_class;
+        } else {
+            bytes = (bytes + page_size - 1) / page_size * page_size;
+        }
+        return bytes / element_size;
+    }
+};
+
+// Doubles until the buffer reaches ThresholdBytes, then grows by StepBytes at a time
+template <std::size_t ThresholdBytes = 64 * 1024 * 1024, std::size_t StepBytes = ThresholdBytes>
+struct LinearAfterThresholdGrowth {
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t element_size)
+    {
+        if (capacity < ThresholdBytes / element_size)
+            return DoublingGrowth::next_capacity(capacity, required, element_size);
+
+        std::size_t step = StepBytes / element_size ? StepBytes / element_size : 1;
+        if (capacity > std::numeric_limits<std::size_t>::max() - step)
+            return vector_detail::at_least(std::numeric_limits<std::size_t>::max(), required);
+        return vector_detail::at_least(capacity + step, required);
+    }
+};
+
+// First allocation fills a cache line. Small buffers double, so short-lived Vectors go
+// through few reallocations. From 64 KiB on, or for elements bigger than a cache line,
+// buffers grow by 1.5x, which bench growth_policies shows costs no time there and leaves
+// a smaller unused tail.
+struct DefaultGrowth {
+    static std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t element_size)
+    {
+        const std::size_t cache_line = 64;
+        const std::size_t large_buffer = 64 * 1024;
+
+        if (capacity == 0)
+            return vector_detail::at_least(element_size < cache_line ? cache_line / element_size : 1, required);
+        if (element_size > cache_line || capacity >= large_buffer / element_size)
+            return OneAndHalfGrowth::next_capacity(capacity, required, element_size);
+        return DoublingGrowth::next_capacity(capacity, required, element_size);
+    }
+};
+
+
+template <typename T, typename A = DefaultAllocator<T>, typename G = DefaultGrowth>
 class Vector {
 //////////////////////////////////////////////////////////////////////////////////////////////
 /// Simple template vector class similar to std::vector
+///
+/// Size and capacity use the allocator's size_type, and a stateless allocator takes no
+/// room, so with CompactAllocator a Vector is a pointer plus two 32-bit counters.
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 public:
 
     typedef A _allocatortype;
-    typedef typename A::size_type size_type;
-    typedef typename A::reference reference;
-    typedef typename A::pointer pointer;
-    typedef typename A::const_reference const_reference;
-    typedef typename A::difference_type difference_type;
+    typedef A allocator_type;
+    typedef T value_type;
+    typedef typename std::allocator_traits<A>::size_type size_type;
+    typedef T& reference;
+    typedef typename std::allocator_traits<A>::pointer pointer;
+    typedef const T& const_reference;
+    typedef typename std::allocator_traits<A>::difference_type difference_type;
     typedef T* iterator;
     typedef const T* const_iterator;
     typedef std::reverse_iterator<iterator> reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
     Vector();                              // No dynamic memory allocation here
-    Vector(size_type size);                // No dynamic memory allocation here
-    Vector(size_type size, const T& init_value);    // Memory allocation for at least [sizeof(T) * size]
-    Vector(const Vector<T, A>& rhs);
-    Vector(Vector<T, A>&& rhs);
+    explicit Vector(const A& allocator);   // No dynamic memory allocation here
+    Vector(size_type size, const A& allocator = A());                         // Reserves room for size elements, Vector stays empty
+    Vector(size_type size, const T& init_value, const A& allocator = A());    // Memory allocation for at least [sizeof(T) * size]
+    Vector(const Vector<T, A, G>& rhs);
+    Vector(const Vector<T, A, G>& rhs, const A& allocator);
+    Vector(Vector<T, A, G>&& rhs) noexcept;
+    Vector(Vector<T, A, G>&& rhs, const A& allocator);
 
     ~Vector();
 
-    const Vector<T, A>& operator =(const Vector<T, A>& rhs);
-    const Vector<T, A>& operator =(Vector<T, A>&& rhs);
+    const Vector<T, A, G>& operator =(const Vector<T, A, G>& rhs);
+    const Vector<T, A, G>& operator =(Vector<T, A, G>&& rhs);
 
-    bool operator ==(const Vector<T, A>& rhs) const;
-    bool operator !=(const Vector<T, A>& rhs) const;
-    bool operator <(const Vector<T, A>& rhs) const;
-    bool operator <=(const Vector<T, A>& rhs) const;
-    bool operator >(const Vector<T, A>& rhs) const;
-    bool operator >=(const Vector<T, A>& rhs) const;
+    allocator_type get_allocator() const;
+
+    bool operator ==(const Vector<T, A, G>& rhs) const;
+    bool operator !=(const Vector<T, A, G>& rhs) const;
+    bool operator <(const Vector<T, A, G>& rhs) const;
+    bool operator <=(const Vector<T, A, G>& rhs) const;
+    bool operator >(const Vector<T, A, G>& rhs) const;
+    bool operator >=(const Vector<T, A, G>& rhs) const;
 
     reference operator [](size_type pos);
     const_reference operator [](size_type pos) const;
@@ -58,145 +636,427 @@ public:
     size_type max_size() const;
     size_type capacity() const;
 
-    iterator begin() const;
-    iterator end() const;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
     const_iterator cbegin() const;
     const_iterator cend() const;
-    reverse_iterator rbegin() const;
-    reverse_iterator rend() const;
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
     const_reverse_iterator crbegin() const;
     const_reverse_iterator crend() const;
 
-    reference front() const;
-    reference back() const;
+    reference front();
+    reference back();
+    const_reference front() const;
+    const_reference back() const;
     const_reference cfront() const;
     const_reference cback() const;
 
-    void clear(); // Is it correct to mark this function as 'noexcept' ?
-    void erease(iterator pos); // repace this with iterators
+    // Existing buffer is reused whenever it is big enough
+    template <typename InputIt, typename = vector_detail::require_iterator<InputIt>>
+    void assign(InputIt first, InputIt last);
+    void assign(size_type count, const T& value);
+
+    void clear() noexcept;       // Destroys elements, keeps capacity
+    void shrink_to_fit();
+    void release_memory() noexcept;
+    iterator erase(iterator pos);
+    iterator erase(iterator first, iterator last);
+    template <typename Predicate>
+    size_type erase_if(Predicate pred);             // Returns number of erased elements
+    iterator unordered_erase(iterator pos);          // O(1), last element takes the place of erased one
+    template <typename PositionIt, typename InputIt>
+    void insert_many(PositionIt pos_first, PositionIt pos_last, InputIt values);
+    template <typename PositionIt>
+    void erase_many(PositionIt pos_first, PositionIt pos_last);
     void reserve(size_type count);
+    void reserve_populated(size_type count);     // reserve() and fault in the spare capacity up front
     void resize(size_type count);
-    void insert(iterator pos, const T& value); // TO DO: modify this with 'noexcept(is_noexcept(T))', or something like this
-    void emplace_back(std::initializer_list<T> init_list);
+    void resize(size_type count, const T& value);
+    void resize_default_init(size_type count);   // New elements are default-initialized, trivial types are left unzeroed
+    void resize_uninitialized(size_type count);  // Trivial types only, new elements hold garbage until written
+    template <typename Writer>
+    void append_with(size_type count, Writer writer);
+    iterator insert(iterator pos, const T& value); // TO DO: modify this with 'noexcept(is_noexcept(T))', or something like this
+    template <typename InputIt, typename = vector_detail::require_iterator<InputIt>>
+    iterator insert(iterator pos, InputIt first, InputIt last);
+    template <typename InputIt, typename = vector_detail::require_iterator<InputIt>>
+    void append(InputIt first, InputIt last);
+    void append(const Vector<T, A, G>& rhs);
+    template <typename... Args>
+    reference emplace_back(Args&&... args);
     void push_back(const T& value);
-    void pop_back(const T& value);
-    void swap(const T& value);
+    void push_back(T&& value);
+
+    // Unchecked variants require capacity() > size(), checked with assert() only
+    template <typename... Args>
+    reference emplace_back_unchecked(Args&&... args);
+    void push_back_unchecked(const T& value);
+    void push_back_unchecked(T&& value);
+
+    class bulk_writer;
+    void pop_back();
+    void swap(Vector<T, A, G>& rhs) noexcept;
 
 
 private:
-    _allocatortype _allocator;
+    template <typename, std::size_t, typename, typename>
+    friend class SmallVector;      // steals heap buffers on move
+
+    void _deallocate() noexcept;
+    void _destroy_tail(size_type new_size) noexcept;
+    void _grow(size_type required);
+    void _grow_by(size_type count);
+    void _reallocate(size_type new_capacity);
+
+    template <typename It>
+    bool _owns(It it) const;
+    bool _owns(const T* p, std::true_type) const;
+    template <typename It>
+    bool _owns(It, std::false_type) const { return false; }
+    template <typename InputIt>
+    void _append(InputIt first, InputIt last, std::input_iterator_tag);
+    template <typename ForwardIt>
+    void _append(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+    template <typename InputIt>
+    void _assign(InputIt first, InputIt last, std::input_iterator_tag);
+    template <typename ForwardIt>
+    void _assign(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+    template <typename InputIt>
+    void _insert(size_type offset, InputIt first, InputIt last, std::input_iterator_tag);
+    template <typename ForwardIt>
+    void _insert(size_type offset, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+    template <typename PositionIt, typename BidirIt>
+    void _insert_many(PositionIt pos_first, PositionIt pos_last, size_type count, BidirIt values, std::true_type);
+    template <typename PositionIt, typename InputIt>
+    void _insert_many(PositionIt pos_first, PositionIt pos_last, size_type count, InputIt values, std::false_type);
+    template <typename PositionIt, typename ValueIt, typename Staged>
+    void _insert_sweep(PositionIt pos_first, PositionIt pos_last, size_type count, ValueIt values_last, Staged staged);
+    template <typename U>
+    void _insert_put(pointer slot, pointer old_end, U&& from);
+    void _insert_put_value(pointer slot, pointer old_end, pointer value, std::true_type);
+    template <typename ValueIt>
+    void _insert_put_value(pointer slot, pointer old_end, ValueIt value, std::false_type);
+
+    A& _allocator() noexcept { return _allocatordata.first(); }
+    const A& _allocator() const noexcept { return _allocatordata.first(); }
+    pointer& _data_array() noexcept { return _allocatordata.second(); }
+    pointer _data_array() const noexcept { return _allocatordata.second(); }
+
     size_type _size;
     size_type _capacity;
-    pointer _data_array;
-};                             
+    vector_detail::CompressedPair<A, pointer> _allocatordata;   // Allocator and buffer
+};
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Vector::bulk_writer
+///
+/// Appends without capacity checks or size updates in the loop: room for 'count' elements
+/// is reserved up front, the end pointer lives in the writer and the Vector size is updated
+/// once, when the writer goes out of scope. The Vector must not be used meanwhile.
+///
+///     {
+///         Vector<int>::bulk_writer writer(vec, n);
+///         for (int i = 0; i < n; ++i)
+///             writer.push_back(i);
+///     }
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename A, typename G>
+class Vector<T, A, G>::bulk_writer {
+public:
+    bulk_writer(Vector<T, A, G>& vector, size_type count);
+    bulk_writer(const bulk_writer&) = delete;
+    bulk_writer& operator =(const bulk_writer&) = delete;
+
+    ~bulk_writer();
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args);
+    void push_back(const T& value);
+    void push_back(T&& value);
+
+private:
+    Vector<T, A, G>& _vector;
+    pointer _end;
+    pointer _limit;
+};
+                             
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// VectorAllocator implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+constexpr typename VectorAllocator<T>::size_type VectorAllocator<T>::mmap_threshold;
+
+template <typename T>
+typename VectorAllocator<T>::size_type VectorAllocator<T>::_bytes(size_type n)
+{
+    if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+        throw std::bad_alloc();
+    return n * sizeof(T);
+}
+
+template <typename T>
+typename VectorAllocator<T>::pointer VectorAllocator<T>::allocate(size_type n)
+{
+    size_type bytes = _bytes(n);
+
+#if defined(__linux__)
+    if (_is_mapped(n))
+        return static_cast<pointer>(vector_detail::map_block(_mapped_bytes(n)));
+#endif
+
+    void* p = std::malloc(bytes);
+    if (!p && n)
+        throw std::bad_alloc();
+    return static_cast<pointer>(p);
+}
+
+template <typename T>
+allocation_result<typename VectorAllocator<T>::pointer, typename VectorAllocator<T>::size_type>
+VectorAllocator<T>::allocate_at_least(size_type n)
+{
+    allocation_result<pointer, size_type> block = { allocate(n), n };
+
+#if defined(__linux__)
+    if (_is_mapped(n)) {
+        block.count = _mapped_bytes(n) / sizeof(T);
+        return block;
+    }
+#endif
+#if defined(__GLIBC__)
+    // Stay below mmap_threshold, deallocate() tells block kinds apart by their size
+    size_type usable = block.ptr ? malloc_usable_size(block.ptr) / sizeof(T) : n;
+    size_type limit = _first_mapped() - 1;
+    if (usable > n)
+        block.count = usable < limit ? usable : (n > limit ? n : limit);
+#endif
+    return block;
+}
+
+template <typename T>
+void VectorAllocator<T>::deallocate(pointer p, size_type n) noexcept
+{
+#if defined(__linux__)
+    if (_is_mapped(n)) {
+        vector_detail::release_block(p, _mapped_bytes(n));
+        return;
+    }
+#endif
+    (void)n;
+    std::free(p);
+}
+
+template <typename T>
+bool VectorAllocator<T>::try_expand(pointer p, size_type old_n, size_type new_n) noexcept
+{
+    if (_is_mapped(old_n) != _is_mapped(new_n))
+        return false;
+
+#if defined(__linux__)
+    if (_is_mapped(old_n))
+        return vector_detail::try_expand_block(p, _mapped_bytes(old_n), _mapped_bytes(new_n));
+#endif
+
+    if (new_n <= old_n)
+        return new_n == old_n; // malloc can't give memory back without realloc()
+#if defined(__GLIBC__)
+    // malloc usually hands out more than requested, growth into that slack is free
+    return new_n <= malloc_usable_size(p) / sizeof(T);
+#else
+    (void)p;
+    return false;
+#endif
+}
+
+template <typename T>
+typename VectorAllocator<T>::pointer VectorAllocator<T>::reallocate(pointer p, size_type old_n, size_type new_n)
+{
+    size_type bytes = _bytes(new_n);
+
+#if defined(__linux__)
+    if (_is_mapped(old_n) && _is_mapped(new_n)) {
+        void* new_p = mremap(p, _mapped_bytes(old_n), _mapped_bytes(new_n), MREMAP_MAYMOVE);
+        if (new_p == MAP_FAILED)
+            throw std::bad_alloc();
+        return static_cast<pointer>(new_p);
+    }
+
+    if (_is_mapped(old_n) || _is_mapped(new_n)) {
+        // Crossing the threshold, the block changes its kind and has to be copied once
+        pointer new_p = allocate(new_n);
+        std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), _bytes(old_n < new_n ? old_n : new_n));
+        deallocate(p, old_n);
+        return new_p;
+    }
+#endif
+
+    void* new_p = std::realloc(p, bytes);
+    if (!new_p && new_n)
+        throw std::bad_alloc(); // old block is left untouched
+    return static_cast<pointer>(new_p);
+}
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 /// Vector implementation
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-template <typename T, typename A>
-Vector<T, A>::Vector() :
-_allocator(A())
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector() :
+    _allocatordata(A(), nullptr)
 {
     _size = 0;
     _capacity = 0;
-    _data_array = nullptr;
 }
 
-template <typename T, typename A>
-Vector<T, A>::Vector(size_type size) :
-    _allocator(A())
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector(const A& allocator) :
+    _allocatordata(allocator, nullptr)
 {
     _size = 0;
-    _capacity = size;
-    _data_array = _allocator.allocate(_capacity);
+    _capacity = 0;
 }
 
-template <typename T, typename A>
-Vector<T, A>::Vector(size_type size, const T &init_value) :
-    _allocator(A())
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector(size_type size, const A& allocator) :
+    _allocatordata(allocator, nullptr)
 {
-    _size = size;
-    _capacity = size;
-    _data_array = _allocator.allocate(_capacity);
-
-    for (size_type i=0; i < size; ++i)
-        _allocator.construct(&_data_array[i], init_value);
+    allocation_result<pointer, size_type> block = vector_detail::allocate_at_least(_allocator(), size);
+    _size = 0;
+    _capacity = block.count;
+    _data_array() = block.ptr;
 }
 
-template <typename T, typename A>
-Vector<T, A>::Vector(const Vector<T, A>& rhs) :
-    _allocator(A())
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector(size_type size, const T &init_value, const A& allocator) :
+    _allocatordata(allocator, nullptr)
 {
-    if (_allocator.get_allocator != rhs._allocator.get_allocator())
-        throw "INTERNAL ERROR: user provided allocators not supported yet"; // TO DO: implement this funcionality. More info: 'C++ Standard Library, second edition' page 1086 (Polish edition)
+    _size = 0;
+    _capacity = 0;
 
-    _capacity = rhs._capacity;
-    _size = rhs._size;
-    _data_array = _allocator.allocate(_capacity);
+    assign(size, init_value);
+}
+
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector(const Vector<T, A, G>& rhs) :
+    _allocatordata(std::allocator_traits<A>::select_on_container_copy_construction(rhs._allocator()), nullptr)
+{
+    _size = 0;
+    _capacity = 0;
 
-    for (size_type i=0; i < _size; ++i)
-        _allocator.construct(&_data_array[i], rhs._data_array[i]);
+    assign(rhs._data_array(), rhs._data_array() + rhs._size);
 }
 
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector(const Vector<T, A, G>& rhs, const A& allocator) :
+    _allocatordata(allocator, nullptr)
+{
+    _size = 0;
+    _capacity = 0;
+
+    assign(rhs._data_array(), rhs._data_array() + rhs._size);
+}
 
-template <typename T, typename A>
-Vector<T, A>::Vector(Vector<T, A>&& rhs) :
-    _allocator(rhs._allocator)
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector(Vector<T, A, G>&& rhs) noexcept :
+    _allocatordata(std::move(rhs._allocator()), nullptr)
 {
     _size = rhs._size;
     _capacity = rhs._capacity;
-    _data_array = rhs._data_array;
+    _data_array() = rhs._data_array();
 
     rhs._size = 0;
     rhs._capacity = 0;
-    rhs._data_array = nullptr;
+    rhs._data_array() = nullptr;
 }
 
-template <typename T, typename A>
-Vector<T, A>::~Vector()
+// Buffer can be stolen only if it was allocated by an equal allocator,
+// otherwise elements are moved one by one
+template <typename T, typename A, typename G>
+Vector<T, A, G>::Vector(Vector<T, A, G>&& rhs, const A& allocator) :
+    _allocatordata(allocator, nullptr)
 {
-    if (_data_array) {
-        _allocator.deallocate(_data_array, _capacity);
-    }
+    _size = 0;
+    _capacity = 0;
+
+    if (_allocator() == rhs._allocator())
+        swap(rhs);
+    else
+        assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
 }
 
-template <typename T, typename A>
-const Vector<T, A>& Vector<T, A>::operator =(const Vector<T, A>& rhs)
+template <typename T, typename A, typename G>
+Vector<T, A, G>::~Vector()
 {
-    if (_allocator.get_allocator != rhs._allocator.get_allocator())
-        throw "INTERNAL ERROR: user provided allocators not supported yet"; // TO DO: implement this funcionality. More info: 'C++ Standard Library, second edition' page 1086 (Polish edition)
+    _deallocate();
+}
 
-    _capacity = rhs._capacity;
-    _size = rhs._size;
-    _data_array = _allocator.allocate(_capacity);
+template <typename T, typename A, typename G>
+const Vector<T, A, G>& Vector<T, A, G>::operator =(const Vector<T, A, G>& rhs)
+{
+    if (this == &rhs)
+        return *this;
+
+    if (std::allocator_traits<A>::propagate_on_container_copy_assignment::value) {
+        // Memory owned by the current allocator has to go back to it before it is replaced
+        if (_allocator() != rhs._allocator())
+            _deallocate();
+        vector_detail::copy_allocator(_allocator(), rhs._allocator(),
+                                      typename std::allocator_traits<A>::propagate_on_container_copy_assignment());
+    }
 
-    for (size_type i=0; i < _size; ++i)
-        _allocator.construct(&_data_array[i], rhs._data_array[i]);
+    assign(rhs._data_array(), rhs._data_array() + rhs._size);
+    return *this;
 }
 
-template <typename T, typename A>
-const Vector<T, A>& Vector<T, A>::operator =(Vector<T, A>&& rhs)
+template <typename T, typename A, typename G>
+const Vector<T, A, G>& Vector<T, A, G>::operator =(Vector<T, A, G>&& rhs)
 {
-    if (_allocator.get_allocator != rhs._allocator.get_allocator())
-        throw "INTERNAL ERROR: user provided allocators not supported yet"; // TO DO: implement this funcionality. More info: 'C++ Standard Library, second edition' page 1086 (Polish edition)
+    if (this == &rhs)
+        return *this;
+
+    if (!std::allocator_traits<A>::propagate_on_container_move_assignment::value && _allocator() != rhs._allocator()) {
+        // Buffer belongs to a different allocator, only elements can be moved
+        assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+        return *this;
+    }
+
+    _deallocate();
+    vector_detail::move_allocator(_allocator(), rhs._allocator(),
+                                  typename std::allocator_traits<A>::propagate_on_container_move_assignment());
 
     _size = rhs._size;
     _capacity = rhs._capacity;
-    _data_array = rhs._data_array;
+    _data_array() = rhs._data_array();
 
     rhs._size = 0;
     rhs._capacity = 0;
-    rhs._data_array = nullptr;
+    rhs._data_array() = nullptr;
+
+    return *this;
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::allocator_type Vector<T, A, G>::get_allocator() const
+{
+    return _allocator();
 }
 
-template <typename T, typename A>
-bool Vector<T, A>::operator ==(const Vector<T, A>& rhs) const
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::operator ==(const Vector<T, A, G>& rhs) const
 {
-    if (_data_array == rhs._data_array && _size == rhs._size) {
+    if (_data_array() == rhs._data_array() && _size == rhs._size) {
         for (size_type i=0; i < _size; ++i) {
-            if (_data_array[i] == rhs._data_array[i])
+            if (_data_array()[i] == rhs._data_array()[i])
                 continue;
             else
                 return false;
@@ -206,18 +1066,18 @@ bool Vector<T, A>::operator ==(const Vector<T, A>& rhs) const
         return false;
 }
 
-template <typename T, typename A>
-bool Vector<T, A>::operator !=(const Vector<T, A>& rhs) const
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::operator !=(const Vector<T, A, G>& rhs) const
 {
     return !(*this == rhs);
 }
 
-template <typename T, typename A>
-bool Vector<T, A>::operator <(const Vector<T, A>& rhs) const
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::operator <(const Vector<T, A, G>& rhs) const
 {
-    if (_data_array == rhs._data_array && _size == rhs._size) {
+    if (_data_array() == rhs._data_array() && _size == rhs._size) {
         for (size_type i=0; i < _size; ++i) {
-            if (_data_array[i] < rhs._data_array[i])
+            if (_data_array()[i] < rhs._data_array()[i])
                 continue;
             else
                 return false;
@@ -227,12 +1087,12 @@ bool Vector<T, A>::operator <(const Vector<T, A>& rhs) const
         return false;
 }
 
-template <typename T, typename A>
-bool Vector<T, A>::operator <=(const Vector<T, A>& rhs) const
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::operator <=(const Vector<T, A, G>& rhs) const
 {
-    if (_data_array == rhs._data_array && _size == rhs._size) {
+    if (_data_array() == rhs._data_array() && _size == rhs._size) {
         for (size_type i=0; i < _size; ++i) {
-            if (_data_array[i] <= rhs._data_array[i])
+            if (_data_array()[i] <= rhs._data_array()[i])
                 continue;
             else
                 return false;
@@ -242,12 +1102,12 @@ bool Vector<T, A>::operator <=(const Vector<T, A>& rhs) const
         return false;
 }
 
-template <typename T, typename A>
-bool Vector<T, A>::operator >(const Vector<T, A>& rhs) const
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::operator >(const Vector<T, A, G>& rhs) const
 {
-    if (_data_array == rhs._data_array && _size == rhs._size) {
+    if (_data_array() == rhs._data_array() && _size == rhs._size) {
         for (size_type i=0; i < _size; ++i) {
-            if (_data_array[i] > rhs._data_array[i])
+            if (_data_array()[i] > rhs._data_array()[i])
                 continue;
             else
                 return false;
@@ -257,12 +1117,12 @@ bool Vector<T, A>::operator >(const Vector<T, A>& rhs) const
         return false;
 }
 
-template <typename T, typename A>
-bool Vector<T, A>::operator >=(const Vector<T, A>& rhs) const
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::operator >=(const Vector<T, A, G>& rhs) const
 {
-    if (_data_array == rhs._data_array && _size == rhs._size) {
+    if (_data_array() == rhs._data_array() && _size == rhs._size) {
         for (size_type i=0; i < _size; ++i) {
-            if (_data_array[i] >= rhs._data_array[i])
+            if (_data_array()[i] >= rhs._data_array()[i])
                 continue;
             else
                 return false;
@@ -272,14 +1132,20 @@ bool Vector<T, A>::operator >=(const Vector<T, A>& rhs) const
         return false;
 }
 
-template <typename T, typename A>
-typename Vector<T, A>::reference Vector<T, A>::operator [](size_type pos)
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::reference Vector<T, A, G>::operator [](size_type pos)
 {
-    return _data_array[pos];
+    return _data_array()[pos];
 }
 
-template <typename T, typename A>
-bool Vector<T, A>::empty() const
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reference Vector<T, A, G>::operator [](size_type pos) const
+{
+    return _data_array()[pos];
+}
+
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::empty() const
 {
     if (_size == 0)
         return true;
@@ -287,191 +1153,908 @@ bool Vector<T, A>::empty() const
         return false;
 }
 
-template <typename T, typename A>
-typename Vector<T, A>::size_type Vector<T, A>::size() const
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::size_type Vector<T, A, G>::size() const
 {
     return _size;
 }
 
-template <typename T, typename A>
-typename Vector<T, A>::size_type Vector<T, A>::max_size() const
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::size_type Vector<T, A, G>::max_size() const
 {
-    return std::numeric_limits<size_type>::max();
+    return std::allocator_traits<A>::max_size(_allocator());
 }
 
-template <typename T, typename A>
-typename Vector<T, A>::size_type Vector<T, A>::capacity() const
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::size_type Vector<T, A, G>::capacity() const
 {
     return _capacity;
 }
 
-template <typename T, typename A>
-typename Vector<T, A>::iterator Vector<T, A>::begin() const
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::iterator Vector<T, A, G>::begin()
 {
-    iterator x = _data_array;
-    return x;
+    return _data_array();
 }
 
-template <typename T, typename A>
-typename Vector<T, A>::iterator Vector<T, A>::end() const
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::iterator Vector<T, A, G>::end()
 {
-    iterator x = _data_array + _size;
-    return x;
+    return _data_array() + _size;
 }
 
-//template <typename T, typename A>
-//typename Vector<T, A>::const_iterator Vector<T, A>::cbegin() const
-//{
-//    const_iterator x;
-//    x.container_ = _data_array;
-//    x.actual_element_ = _data_array;
-//    x.first_element_ = _data_array;
-//    x.last_element_ = _data_array + _size;
-
-//    return x;
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_iterator Vector<T, A, G>::begin() const
+{
+    return _data_array();
+}
 
-//}
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_iterator Vector<T, A, G>::end() const
+{
+    return _data_array() + _size;
+}
 
-//template <typename T, typename A>
-//typename Vector<T, A>::const_iterator Vector<T, A>::cend() const
-//{
-//    const_iterator x;
-//    x.container_ = _data_array;
-//    x.actual_element_ = _data_array + _size;
-//    x.first_element_ = _data_array;
-//    x.last_element_ = _data_array + _size;
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_iterator Vector<T, A, G>::cbegin() const
+{
+    return begin();
+}
 
-//    return x;
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_iterator Vector<T, A, G>::cend() const
+{
+    return end();
+}
 
-//}
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::reverse_iterator Vector<T, A, G>::rbegin()
+{
+    return reverse_iterator(end());
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::reverse_iterator Vector<T, A, G>::rend()
+{
+    return reverse_iterator(begin());
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reverse_iterator Vector<T, A, G>::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reverse_iterator Vector<T, A, G>::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reverse_iterator Vector<T, A, G>::crbegin() const
+{
+    return rbegin();
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reverse_iterator Vector<T, A, G>::crend() const
+{
+    return rend();
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::reference Vector<T, A, G>::front()
+{
+    return _data_array()[0]; // first array element
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::reference Vector<T, A, G>::back()
+{
+    return _data_array()[_size - 1]; // last array element
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reference Vector<T, A, G>::front() const
+{
+    return _data_array()[0];
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reference Vector<T, A, G>::back() const
+{
+    return _data_array()[_size - 1];
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reference Vector<T, A, G>::cfront() const
+{
+    return front();
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::const_reference Vector<T, A, G>::cback() const
+{
+    return back();
+}
 
-//template <typename T, typename A>
-//typename Vector<T, A>::reverse_iterator Vector<T, A>::rbegin() const
-//{
-//    reverse_iterator x;
-//    x.container_ = _data_array;
-//    x.actual_element_ = _data_array + _size;
-//    x.first_element_ = _data_array + _size;
-//    x.last_element_ = _data_array;
+template <typename T, typename A, typename G>
+template <typename InputIt, typename>
+void Vector<T, A, G>::assign(InputIt first, InputIt last)
+{
+    _assign(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
 
-//    return x;
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::assign(size_type count, const T& value)
+{
+    if (count > _capacity) {
+        allocation_result<pointer, size_type> block = vector_detail::allocate_at_least(_allocator(), count);
+        size_type constructed = 0;
+        try {
+            for (; constructed < count; ++constructed)
+                std::allocator_traits<A>::construct(_allocator(), block.ptr + constructed, value);
+        } catch (...) {
+            vector_detail::destroy(_allocator(), block.ptr, block.ptr + constructed);
+            std::allocator_traits<A>::deallocate(_allocator(), block.ptr, block.count);
+            throw;
+        }
+        _deallocate();
+        _data_array() = block.ptr;
+        _capacity = block.count;
+        _size = count;
+        return;
+    }
 
-//}
+    std::fill_n(_data_array(), count < _size ? count : _size, value);
+    if (count <= _size) {
+        _destroy_tail(count);
+        return;
+    }
+    for (; _size < count; ++_size)
+        std::allocator_traits<A>::construct(_allocator(), end(), value);
+}
 
-//template <typename T, typename A>
-//typename Vector<T, A>::reverse_iterator Vector<T, A>::rend() const
-//{
-//    reverse_iterator x;
-//    x.container_ = _data_array;
-//    x.actual_element_ = _data_array;
-//    x.first_element_ = _data_array + _size;
-//    x.last_element_ = _data_array;
+// Copy-assigns over live elements, constructs the rest, destroys leftovers
+template <typename T, typename A, typename G>
+template <typename InputIt>
+void Vector<T, A, G>::_assign(InputIt first, InputIt last, std::input_iterator_tag)
+{
+    pointer current = _data_array();
+    for (; first != last && current != end(); ++first, ++current)
+        *current = *first;
 
-//    return x;
+    if (first == last)
+        _destroy_tail(current - _data_array());
+    else
+        append(first, last);
+}
 
-//}
+// Trivially copyable elements from pointers are copied with memmove/memcpy
+template <typename T, typename A, typename G>
+template <typename ForwardIt>
+void Vector<T, A, G>::_assign(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+{
+    size_type count = std::distance(first, last);
+
+    if (count > _capacity) {
+        allocation_result<pointer, size_type> block = vector_detail::allocate_at_least(_allocator(), count);
+        try {
+            vector_detail::uninitialized_copy(_allocator(), first, last, block.ptr);
+        } catch (...) {
+            std::allocator_traits<A>::deallocate(_allocator(), block.ptr, block.count);
+            throw;
+        }
+        _deallocate();
+        _data_array() = block.ptr;
+        _capacity = block.count;
+        _size = count;
+        return;
+    }
+
+    if (count <= _size) {
+        std::copy(first, last, _data_array());
+        _destroy_tail(count);
+        return;
+    }
+
+    ForwardIt middle = first;
+    std::advance(middle, _size);
+    std::copy(first, middle, _data_array());
+    vector_detail::uninitialized_copy(_allocator(), middle, last, end());
+    _size = count;
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::clear() noexcept
+{
+    _destroy_tail(0);
+}
+
+// Shrinks in place when the allocator can (try_expand, or realloc() for relocatable types)
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::shrink_to_fit()
+{
+    if (_size == _capacity)
+        return;
 
-//template <typename T, typename A>
-//typename Vector<T, A>::const_reverse_iterator Vector<T, A>::crbegin() const
-//{
-//    const_reverse_iterator x;
-//    x.container_ = _data_array;
-//    x.actual_element_ = _data_array + _size;
-//    x.first_element_ = _data_array + _size;
-//    x.last_element_ = _data_array;
+    if (_size == 0) {
+        release_memory();
+        return;
+    }
+
+    _reallocate(_size);
+}
 
-//    return x;
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::release_memory() noexcept
+{
+    _deallocate();
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::iterator Vector<T, A, G>::erase(iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+// Trivially relocatable tail is shifted with a single memmove
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::iterator Vector<T, A, G>::erase(iterator first, iterator last)
+{
+    if (first == last)
+        return first;
+
+    size_type count = last - first;
+    if (is_trivially_relocatable<T>::value) {
+        vector_detail::destroy(_allocator(), first, last);
+        std::memmove(static_cast<void*>(first), static_cast<const void*>(last), (end() - last) * sizeof(T));
+        _size -= count;
+    } else {
+        std::move(last, end(), first);
+        _destroy_tail(_size - count);
+    }
+    return first;
+}
+
+// One pass compaction, every kept element is moved at most once
+template <typename T, typename A, typename G>
+template <typename Predicate>
+typename Vector<T, A, G>::size_type Vector<T, A, G>::erase_if(Predicate pred)
+{
+    size_type old_size = _size;
+
+    if (!is_trivially_relocatable<T>::value) {
+        _destroy_tail(std::remove_if(begin(), end(), pred) - begin());
+        return old_size - _size;
+    }
+
+    pointer read = _data_array();
+    pointer write = _data_array();
+    pointer last = end();
+    try {
+        for (; read != last; ++read) {
+            if (pred(*read)) {
+                std::allocator_traits<A>::destroy(_allocator(), read);
+            } else {
+                if (write != read)
+                    std::memcpy(static_cast<void*>(write), static_cast<const void*>(read), sizeof(T));
+                ++write;
+            }
+        }
+    } catch (...) {
+        // Close the gap so that Vector stays contiguous
+        std::memmove(static_cast<void*>(write), static_cast<const void*>(read), (last - read) * sizeof(T));
+        _size -= read - write;
+        throw;
+    }
+
+    _size = write - _data_array();
+    return old_size - _size;
+}
+
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::iterator Vector<T, A, G>::unordered_erase(iterator pos)
+{
+    pointer last = end() - 1;
+    if (pos != last) {
+        if (is_trivially_relocatable<T>::value) {
+            std::allocator_traits<A>::destroy(_allocator(), pos);
+            std::memcpy(static_cast<void*>(pos), static_cast<const void*>(last), sizeof(T));
+            --_size;
+            return pos;
+        }
+        *pos = std::move(*last);
+    }
+    _destroy_tail(_size - 1);
+    return pos;
+}
+
+// Inserts values[i] before the element at index pos_first[i]. Indices refer to the Vector
+// before the call and must be sorted (equal ones keep the order of their values).
+// Whole batch costs a single O(size + count) sweep and at most one reallocation.
+// When moves may throw, a batch which grows the Vector leaves it intact on failure, one
+// which fits the capacity leaves valid (possibly moved-from) elements, like std::vector.
+template <typename T, typename A, typename G>
+template <typename PositionIt, typename InputIt>
+void Vector<T, A, G>::insert_many(PositionIt pos_first, PositionIt pos_last, InputIt values)
+{
+    typedef typename std::iterator_traits<InputIt>::reference value_reference;
+    typedef typename std::iterator_traits<InputIt>::iterator_category value_category;
+
+    size_type count = std::distance(pos_first, pos_last);
+    if (count == 0)
+        return;
+
+    if (count > _capacity - _size && !is_trivially_relocatable<T>::value &&
+        !(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value)) {
+        // Moves may throw, build the result in the new buffer to keep the Vector intact
+        Vector<T, A, G> result(_allocator());
+        result.reserve(_size + count);
+        size_type done = 0;
+        for (; pos_first != pos_last; ++pos_first, ++values) {
+            result.append(_data_array() + done, _data_array() + *pos_first);
+            result.emplace_back_unchecked(*values);
+            done = *pos_first;
+        }
+        result.append(_data_array() + done, end());
+        *this = std::move(result);
+        return;
+    }
+
+    // Values are read in place when they can be walked backwards and copied without throwing
+    _insert_many(pos_first, pos_last, count, values,
+                 std::integral_constant<bool, std::is_base_of<std::bidirectional_iterator_tag, value_category>::value &&
+                                              std::is_nothrow_constructible<T, value_reference>::value &&
+                                              (is_trivially_relocatable<T>::value ||
+                                               std::is_nothrow_assignable<T&, value_reference>::value)>());
+}
+
+template <typename T, typename A, typename G>
+template <typename PositionIt, typename BidirIt>
+void Vector<T, A, G>::_insert_many(PositionIt pos_first, PositionIt pos_last, size_type count, BidirIt values,
+                                   std::true_type)
+{
+    if (_owns(values)) {
+        _insert_many(pos_first, pos_last, count, values, std::false_type());
+        return;
+    }
+
+    if (count > _capacity - _size)
+        _grow_by(count);
+    BidirIt values_last = values;
+    std::advance(values_last, count);
+    _insert_sweep(pos_first, pos_last, count, values_last, std::false_type());
+}
+
+// Values may alias elements, be single pass, or throw when copied: copy them out first
+template <typename T, typename A, typename G>
+template <typename PositionIt, typename InputIt>
+void Vector<T, A, G>::_insert_many(PositionIt pos_first, PositionIt pos_last, size_type count, InputIt values,
+                                   std::false_type)
+{
+    Vector<T, A, G> staged(_allocator());
+    staged.reserve(count);
+    for (size_type i = 0; i < count; ++i, ++values)
+        staged.emplace_back_unchecked(*values);
+
+    if (count > _capacity - _size)
+        _grow_by(count);
+    _insert_sweep(pos_first, pos_last, count, staged.end(), std::true_type());
+
+    if (is_trivially_relocatable<T>::value)
+        staged._size = 0; // values were relocated, not copied
+}
+
+// Sweeps backwards: shifts each run of old elements up by the number of values before it
+// and puts *--values_last in front of it. Room for count more elements must be reserved.
+// Staged values are relocated (or moved) out of the staging buffer, others are copied.
+template <typename T, typename A, typename G>
+template <typename PositionIt, typename ValueIt, typename Staged>
+void Vector<T, A, G>::_insert_sweep(PositionIt pos_first, PositionIt pos_last, size_type count, ValueIt values_last,
+                                    Staged staged)
+{
+    pointer old_end = end();
+    pointer src = old_end;
+    pointer dest = old_end + count;
+    pointer filled = dest;      // Slots from here up to old_end + count hold constructed elements
+
+    try {
+        PositionIt pos = pos_last;
+        while (pos != pos_first) {
+            --pos;
+            assert(*pos <= _size && _data_array() + *pos <= src);
+
+            pointer run = _data_array() + *pos;
+            size_type run_length = src - run;
+            dest -= run_length;
+            if (is_trivially_relocatable<T>::value) {
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(run), run_length * sizeof(T));
+            } else {
+                for (size_type i = run_length; i-- > 0; filled = dest + i)
+                    _insert_put(dest + i, old_end, std::move(run[i]));
+            }
+            src = run;
+
+            --dest;
+            --values_last;
+            _insert_put_value(dest, old_end, values_last, staged);
+            filled = dest;
+        }
+    } catch (...) {
+        // Only moves of non-relocatable elements can throw here, old elements stay live
+        if (filled < old_end)
+            filled = old_end;
+        vector_detail::destroy(_allocator(), filled, old_end + count);
+        throw;
+    }
+
+    _size += count;
+}
+
+// Slots past old_end are raw memory, the ones before hold live (possibly moved-from)
+// elements, or raw bytes once relocatable elements were memmoved away
+template <typename T, typename A, typename G>
+template <typename U>
+void Vector<T, A, G>::_insert_put(pointer slot, pointer old_end, U&& from)
+{
+    if (is_trivially_relocatable<T>::value || slot >= old_end)
+        std::allocator_traits<A>::construct(_allocator(), slot, std::forward<U>(from));
+    else
+        *slot = std::forward<U>(from);
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::_insert_put_value(pointer slot, pointer old_end, pointer value, std::true_type)
+{
+    if (is_trivially_relocatable<T>::value)
+        std::memcpy(static_cast<void*>(slot), static_cast<const void*>(value), sizeof(T));
+    else
+        _insert_put(slot, old_end, std::move(*value));
+}
+
+template <typename T, typename A, typename G>
+template <typename ValueIt>
+void Vector<T, A, G>::_insert_put_value(pointer slot, pointer old_end, ValueIt value, std::false_type)
+{
+    _insert_put(slot, old_end, *value);
+}
+
+// Erases elements at sorted indices (duplicates are ignored) in a single sweep,
+// each kept element is moved at most once
+template <typename T, typename A, typename G>
+template <typename PositionIt>
+void Vector<T, A, G>::erase_many(PositionIt pos_first, PositionIt pos_last)
+{
+    if (pos_first == pos_last)
+        return;
 
-//}
+    pointer write = _data_array() + *pos_first;
+    while (pos_first != pos_last) {
+        size_type erased = *pos_first;
+        assert(erased < _size);
+        do
+            ++pos_first;
+        while (pos_first != pos_last && *pos_first == erased);
+
+        pointer run_first = _data_array() + erased + 1;
+        pointer run_last = pos_first != pos_last ? _data_array() + *pos_first : end();
+        assert(run_first <= run_last);
+
+        if (is_trivially_relocatable<T>::value) {
+            std::allocator_traits<A>::destroy(_allocator(), _data_array() + erased);
+            std::memmove(static_cast<void*>(write), static_cast<const void*>(run_first), (run_last - run_first) * sizeof(T));
+        } else {
+            std::move(run_first, run_last, write);
+        }
+        write += run_last - run_first;
+    }
 
-//template <typename T, typename A>
-//typename Vector<T, A>::const_reverse_iterator Vector<T, A>::crend() const
-//{
-//    const_reverse_iterator x;
-//    x.container_ = _data_array;
-//    x.actual_element_ = _data_array;
-//    x.first_element_ = _data_array + _size;
-//    x.last_element_ = _data_array;
+    if (is_trivially_relocatable<T>::value)
+        _size = write - _data_array();
+    else
+        _destroy_tail(write - _data_array());
+}
 
-//    return x;
+// O(1): only pointers and sizes are exchanged. Allocators are swapped when
+// propagate_on_container_swap says so, otherwise they have to compare equal.
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::swap(Vector<T, A, G>& rhs) noexcept
+{
+    assert(std::allocator_traits<A>::propagate_on_container_swap::value || _allocator() == rhs._allocator());
 
-//}
+    vector_detail::swap_allocators(_allocator(), rhs._allocator(),
+                                   typename std::allocator_traits<A>::propagate_on_container_swap());
+    std::swap(_size, rhs._size);
+    std::swap(_capacity, rhs._capacity);
+    std::swap(_data_array(), rhs._data_array());
+}
 
-template <typename T, typename A>
-typename Vector<T, A>::reference Vector<T, A>::front() const
+template <typename T, typename A, typename G>
+void swap(Vector<T, A, G>& lhs, Vector<T, A, G>& rhs) noexcept
 {
-    return _data_array[0]; // first array element
+    lhs.swap(rhs);
 }
 
-template <typename T, typename A>
-typename Vector<T, A>::reference Vector<T, A>::back() const
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::pop_back()
 {
-    return _data_array[_size - 1]; // last array element
+    assert(_size > 0);
+    _destroy_tail(_size - 1);
 }
 
-//template <typename T, typename A>
-//typename Vector<T, A>::const_reference Vector<T, A>::cfront() const
-//{
-//    return _data_array[0];
-//}
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::reserve(size_type count)
+{
+    if (_capacity >= count) // No memory operations needed
+        return;
 
-//template <typename T, typename A>
-//typename Vector<T, A>::const_reference Vector<T, A>::cback() const
-//{
-//    return _data_array[_size - 1];
-//}
+    _reallocate(count);
+}
 
-template <typename T, typename A>
-void Vector<T, A>::clear()
+// Appends within the reserved capacity never take a page fault, as long as the pages stay
+// resident (see LockedAllocator to pin them)
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::reserve_populated(size_type count)
 {
-    _allocator.dealocate(_data_array, _capacity);
-    _data_array = nullptr;
+    reserve(count);
+    vector_detail::prefault(static_cast<void*>(end()), (_capacity - _size) * sizeof(T));
+}
+
+// Destroys all elements and frees the buffer, leaves Vector in a moved-from state
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::_deallocate() noexcept
+{
+    if (_data_array()) {
+        vector_detail::destroy(_allocator(), _data_array(), _data_array() + _size);
+        std::allocator_traits<A>::deallocate(_allocator(), _data_array(), _capacity);
+    }
+    _data_array() = nullptr;
     _capacity = 0;
     _size = 0;
 }
 
-//template <typename T, typename A>
-//void Vector<T, A>::erease(typename Vector<T,A>::iterator pos)
-//{
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::_destroy_tail(size_type new_size) noexcept
+{
+    vector_detail::destroy(_allocator(), _data_array() + new_size, _data_array() + _size);
+    _size = new_size;
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::_grow(size_type required)
+{
+    if (required > max_size())
+        throw std::length_error("Vector: capacity exceeds max_size()");
+
+    std::size_t next = G::next_capacity(_capacity, required, sizeof(T));
+    reserve(next < max_size() ? size_type(next) : max_size());
+}
+
+// Checks before adding, _size + count may wrap around with a narrow size_type
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::_grow_by(size_type count)
+{
+    if (count > max_size() - _size)
+        throw std::length_error("Vector: capacity exceeds max_size()");
+
+    _grow(_size + count);
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::_reallocate(size_type new_capacity)
+{
+    if (_data_array()) {
+        if (vector_detail::try_expand(_allocator(), _data_array(), _capacity, new_capacity)) {
+            _capacity = new_capacity;
+            return;
+        }
+        if (vector_detail::reallocate(_allocator(), _data_array(), _capacity, new_capacity)) {
+            _capacity = new_capacity;
+            return;
+        }
+    }
+
+    allocation_result<pointer, size_type> block = vector_detail::allocate_at_least(_allocator(), new_capacity);
+
+    if (_data_array()) {
+        try {
+            vector_detail::relocate(_allocator(), _data_array(), _data_array() + _size, block.ptr);
+        } catch (...) {
+            std::allocator_traits<A>::deallocate(_allocator(), block.ptr, block.count);
+            throw;
+        }
+        std::allocator_traits<A>::deallocate(_allocator(), _data_array(), _capacity);
+    }
+
+    _data_array() = block.ptr;
+    _capacity = block.count;
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::resize(size_type count)
+{
+    if (count <= _size) {
+        _destroy_tail(count);
+        return;
+    }
 
-//}
+    if (count > _capacity)
+        _grow(count);
+    for (; _size < count; ++_size)
+        std::allocator_traits<A>::construct(_allocator(), end());
+}
 
-template <typename T, typename A>
-void Vector<T, A>::reserve(size_type count)
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::resize(size_type count, const T& value)
 {
-    if (_capacity > count) // No memory operations needed
+    if (count <= _size) {
+        _destroy_tail(count);
         return;
+    }
 
-    pointer old_data_array = _data_array;
-    size_type old_capacity = _capacity;
-    _capacity = count;
-    _data_array = _allocator.allocate(_capacity);
+    if (count > _capacity && _owns(&value)) {
+        T copy(value);
+        resize(count, copy);
+        return;
+    }
 
-    for (size_type i=0; i < _size; ++i)
-        _allocator.construct(&_data_array[i], old_data_array[i]);
-    _allocator.deallocate(old_data_array, old_capacity);
+    if (count > _capacity)
+        _grow(count);
+    for (; _size < count; ++_size)
+        std::allocator_traits<A>::construct(_allocator(), end(), value);
 }
 
-//template <typename T, typename A>
-//void Vector<T, A>::resize(size_type count)
-//{
+// Allocators can only value-initialize, so default-initialization uses placement new directly
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::resize_default_init(size_type count)
+{
+    if (count <= _size) {
+        _destroy_tail(count);
+        return;
+    }
+
+    if (count > _capacity)
+        _grow(count);
+    for (; _size < count; ++_size)
+        ::new (static_cast<void*>(end())) T;
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::resize_uninitialized(size_type count)
+{
+    static_assert(std::is_trivial<T>::value, "resize_uninitialized() requires a trivial type, use resize_default_init()");
 
-//}
+    if (count > _capacity)
+        _grow(count);
+    _size = count;
+}
 
-template <typename T, typename A>
-void Vector<T,A>::push_back(const T& value)
+// Writer is called once with a pointer to the raw tail of at least count elements and has to
+// construct them there (plain stores are fine for trivial types). It may return how many
+// elements it really wrote, otherwise all count elements are taken as written.
+template <typename T, typename A, typename G>
+template <typename Writer>
+void Vector<T, A, G>::append_with(size_type count, Writer writer)
 {
-    if (!_data_array)
-        reserve(1);
+    if (count > _capacity - _size)
+        _grow_by(count);
 
-    if (_capacity > _size) {
-    _allocator.construct(end(), value);
-    ++_size;
+    _size += vector_detail::call_writer(writer, end(), count);
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::push_back(const T& value)
+{
+    emplace_back(value);
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::push_back(T&& value)
+{
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename A, typename G>
+template <typename... Args>
+typename Vector<T, A, G>::reference Vector<T, A, G>::emplace_back(Args&&... args)
+{
+    if (_size == _capacity) {
+        // args may refer to an element of this Vector, so build the value before growing
+        T value(std::forward<Args>(args)...);
+        _grow_by(1);
+        std::allocator_traits<A>::construct(_allocator(), end(), std::move(value));
     } else {
-        reserve(2 * _capacity); // TO DO: search for some better algorithm
-        _allocator.construct(end(), value);
-        ++_size;
+        std::allocator_traits<A>::construct(_allocator(), end(), std::forward<Args>(args)...);
     }
+
+    return _data_array()[_size++];
+}
+
+template <typename T, typename A, typename G>
+template <typename InputIt, typename>
+void Vector<T, A, G>::append(InputIt first, InputIt last)
+{
+    _append(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::append(const Vector<T, A, G>& rhs)
+{
+    append(rhs._data_array(), rhs._data_array() + rhs._size);
 }
 
+template <typename T, typename A, typename G>
+typename Vector<T, A, G>::iterator Vector<T, A, G>::insert(iterator pos, const T& value)
+{
+    return insert(pos, &value, &value + 1);
+}
+
+template <typename T, typename A, typename G>
+template <typename InputIt, typename>
+typename Vector<T, A, G>::iterator Vector<T, A, G>::insert(iterator pos, InputIt first, InputIt last)
+{
+    size_type offset = pos - _data_array();
+    _insert(offset, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    return _data_array() + offset;
+}
+
+// Tells if an iterator points into this Vector's buffer, which growth would invalidate.
+// Iterators other than T* (move iterators, proxies, other containers') never do.
+template <typename T, typename A, typename G>
+template <typename It>
+bool Vector<T, A, G>::_owns(It it) const
+{
+    return _owns(it, vector_detail::is_element_pointer<It, T>());
+}
+
+template <typename T, typename A, typename G>
+bool Vector<T, A, G>::_owns(const T* p, std::true_type) const
+{
+    std::less<const T*> less;
+    return !less(p, _data_array()) && less(p, _data_array() + _size);
+}
+
+// Single pass ranges can't be measured up front, they are appended one by one
+template <typename T, typename A, typename G>
+template <typename InputIt>
+void Vector<T, A, G>::_append(InputIt first, InputIt last, std::input_iterator_tag)
+{
+    for (; first != last; ++first)
+        emplace_back(*first);
+}
+
+template <typename T, typename A, typename G>
+template <typename ForwardIt>
+void Vector<T, A, G>::_append(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+{
+    size_type count = std::distance(first, last);
+    if (count == 0)
+        return;
+
+    if (count > _capacity - _size) {
+        if (_owns(first)) {
+            // The source lives in the buffer which is about to move, copy it out first
+            Vector<T, A, G> copy(_allocator());
+            copy.append(first, last);
+            _grow_by(count);
+            vector_detail::relocate(_allocator(), copy._data_array(), copy._data_array() + count, end());
+            copy._size = 0;
+            _size += count;
+            return;
+        }
+        _grow_by(count);
+    }
+
+    vector_detail::uninitialized_copy(_allocator(), first, last, end());
+    _size += count;
+}
+
+// Generic insertion: append, then rotate the new elements into place
+template <typename T, typename A, typename G>
+template <typename InputIt>
+void Vector<T, A, G>::_insert(size_type offset, InputIt first, InputIt last, std::input_iterator_tag)
+{
+    size_type old_size = _size;
+    append(first, last);
+    std::rotate(_data_array() + offset, _data_array() + old_size, _data_array() + _size);
+}
+
+// Trivially relocatable elements make room for the range with a single memmove
+template <typename T, typename A, typename G>
+template <typename ForwardIt>
+void Vector<T, A, G>::_insert(size_type offset, ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+{
+    size_type count = std::distance(first, last);
+    if (count == 0)
+        return;
+
+    if (!is_trivially_relocatable<T>::value || _owns(first)) {
+        _insert(offset, first, last, std::input_iterator_tag());
+        return;
+    }
+
+    if (count > _capacity - _size)
+        _grow_by(count);
+
+    pointer hole = _data_array() + offset;
+    size_type tail = _size - offset;
+    std::memmove(static_cast<void*>(hole + count), static_cast<const void*>(hole), tail * sizeof(T));
+    try {
+        vector_detail::uninitialized_copy(_allocator(), first, last, hole);
+    } catch (...) {
+        std::memmove(static_cast<void*>(hole), static_cast<const void*>(hole + count), tail * sizeof(T));
+        throw;
+    }
+    _size += count;
+}
+
+template <typename T, typename A, typename G>
+template <typename... Args>
+typename Vector<T, A, G>::reference Vector<T, A, G>::emplace_back_unchecked(Args&&... args)
+{
+    assert(_size < _capacity);
+    std::allocator_traits<A>::construct(_allocator(), end(), std::forward<Args>(args)...);
+    return _data_array()[_size++];
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::push_back_unchecked(const T& value)
+{
+    emplace_back_unchecked(value);
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::push_back_unchecked(T&& value)
+{
+    emplace_back_unchecked(std::move(value));
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// Vector::bulk_writer implementation
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, typename A, typename G>
+Vector<T, A, G>::bulk_writer::bulk_writer(Vector<T, A, G>& vector, size_type count) :
+    _vector(vector)
+{
+    if (count > _vector._capacity - _vector._size)
+        _vector._grow_by(count);
+
+    _end = _vector.end();
+    _limit = _end + count;
+}
+
+template <typename T, typename A, typename G>
+Vector<T, A, G>::bulk_writer::~bulk_writer()
+{
+    _vector._size = _end - _vector._data_array();
+}
+
+template <typename T, typename A, typename G>
+template <typename... Args>
+typename Vector<T, A, G>::reference Vector<T, A, G>::bulk_writer::emplace_back(Args&&... args)
+{
+    assert(_end < _limit);
+    std::allocator_traits<A>::construct(_vector._allocator(), _end, std::forward<Args>(args)...);
+    return *_end++;
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::bulk_writer::push_back(const T& value)
+{
+    emplace_back(value);
+}
+
+template <typename T, typename A, typename G>
+void Vector<T, A, G>::bulk_writer::push_back(T&& value)
+{
+    emplace_back(std::move(value));
+}
+
+// Completes DefaultAllocator for over-aligned types; it builds on the definitions above
+#include "AlignedAllocator.hpp"
+
 #endif // VECTOR_HPP
@@ -0,0 +1,87 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// Minimal benchmark helpers
+///
+/// Every benchmark is a plain function printing one line per measurement. Timings use
+/// steady_clock and are the best of a few runs, which filters out scheduler noise but not
+/// cold caches, so each benchmark warms up what it measures itself.
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace bench {
+
+typedef std::chrono::steady_clock clock;
+
+// Sizes are multiplied by scale, set from the command line
+extern double scale;
+
+inline std::size_t scaled(std::size_t value)
+{
+    std::size_t result = static_cast<std::size_t>(value * scale);
+    return result ? result : 1;
+}
+
+inline double seconds_since(clock::time_point start)
+{
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+// Seconds taken by the fastest of 'runs' calls to f
+template <typename F>
+double best_of(int runs, F f)
+{
+    double best = 0;
+    for (int i = 0; i < runs; ++i) {
+        clock::time_point start = clock::now();
+        f();
+        double elapsed = seconds_since(start);
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+// Keeps the optimizer from dropping computations whose result is otherwise unused
+template <typename T>
+void keep(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Value at quantile q (0..1) of samples, which get sorted
+inline double percentile(std::vector<double>& samples, double q)
+{
+    std::sort(samples.begin(), samples.end());
+    std::size_t index = static_cast<std::size_t>(q * (samples.size() - 1));
+    return samples[index];
+}
+
+inline void header(const char* name)
+{
+    std::printf("\n== %s\n", name);
+}
+
+// Benchmarks, one per file
+void growth();
+void growth_policies();
+void pool();
+void huge_pages();
+void numa();
+void latency();
+
+} // namespace bench
+
+#endif // BENCH_HPP
@@ -0,0 +1,121 @@
+#include "bench.hpp"
+#include "../Vector.hpp"
+
+#include <memory>
+
+
+namespace {
+
+// Time of one reserve(2 * n) on a full Vector of n ints, fresh Vector for every run
+template <typename A>
+double doubling_time(std::size_t n)
+{
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        Vector<int, A> vec;
+        vec.reserve(n);
+        vec.resize(n, 1); // touches every page, so a copy has real data to move
+
+        bench::clock::time_point start = bench::clock::now();
+        vec.reserve(2 * n);
+        double elapsed = bench::seconds_since(start);
+        bench::keep(vec[n - 1]);
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+template <std::size_t Size>
+struct Element {
+    char bytes[Size];
+};
+
+// Final sizes swept by growth_policies: 4 KiB up to total_bytes in steps of about 1.3x, so
+// results don't hinge on where one size lands relative to a policy's capacities
+std::vector<std::size_t> final_sizes(std::size_t total_bytes, std::size_t element_size)
+{
+    std::vector<std::size_t> sizes;
+    for (double bytes = 4096; bytes <= total_bytes; bytes *= 1.3)
+        sizes.push_back(static_cast<std::size_t>(bytes) / element_size);
+    return sizes;
+}
+
+// Time of all push_back runs over the sweep, plus mean and worst unused capacity
+template <typename T, typename G>
+void push_back_run(const char* policy, std::size_t total_bytes)
+{
+    std::vector<std::size_t> sizes = final_sizes(total_bytes, sizeof(T));
+    double seconds = 0;
+    double slack = 0;
+    double worst = 0;
+    T value = T();
+
+    for (std::size_t count : sizes) {
+        std::size_t capacity = 0;
+        seconds += bench::best_of(3, [&] {
+            Vector<T, VectorAllocator<T>, G> vec;
+            for (std::size_t i = 0; i < count; ++i)
+                vec.push_back(value);
+            capacity = vec.capacity();
+            bench::keep(vec[count - 1]);
+        });
+        double unused = double(capacity - count) / count;
+        slack += unused;
+        worst = unused > worst ? unused : worst;
+    }
+    std::printf("%-22s %4zu B elements  %8.2f ms  %5.1f%% mean slack  %5.1f%% worst\n", policy, sizeof(T),
+                seconds * 1e3, 100.0 * slack / sizes.size(), 100.0 * worst);
+}
+
+template <typename T>
+void policies(std::size_t total_bytes)
+{
+    push_back_run<T, DefaultGrowth>("DefaultGrowth", total_bytes);
+    push_back_run<T, DoublingGrowth>("DoublingGrowth", total_bytes);
+    push_back_run<T, OneAndHalfGrowth>("OneAndHalfGrowth", total_bytes);
+    push_back_run<T, FibonacciGrowth>("FibonacciGrowth", total_bytes);
+    push_back_run<T, SizeClassGrowth>("SizeClassGrowth", total_bytes);
+    push_back_run<T, LinearAfterThresholdGrowth<>>("LinearAfterThreshold", total_bytes);
+}
+
+// Short-lived 4 KiB Vectors, where the number of reallocations dominates
+template <typename G>
+void short_lived(const char* policy)
+{
+    std::size_t repeat = bench::scaled(20000);
+    double seconds = bench::best_of(3, [&] {
+        for (std::size_t i = 0; i < repeat; ++i) {
+            Vector<int, VectorAllocator<int>, G> vec;
+            for (int j = 0; j < 1024; ++j)
+                vec.push_back(j);
+            bench::keep(vec[0]);
+        }
+    });
+    std::printf("%-22s %8.2f ns per Vector\n", policy, seconds / repeat * 1e9);
+}
+
+} // namespace
+
+// mremap growth should cost about the same at any size, copying grows linearly
+void bench::growth()
+{
+    header("growth: one reserve() doubling a full Vector<int>");
+    for (std::size_t bytes = scaled(1 << 20); bytes <= scaled(256 << 20); bytes *= 4) {
+        std::size_t n = bytes / sizeof(int);
+        std::printf("%8.1f MiB  VectorAllocator %8.3f ms  std::allocator %8.3f ms\n", bytes / 1048576.0,
+                    doubling_time<VectorAllocator<int>>(n) * 1e3, doubling_time<std::allocator<int>>(n) * 1e3);
+    }
+}
+
+void bench::growth_policies()
+{
+    header("growth_policies: push_back into empty Vectors, 4 KiB to 64 MiB final size");
+    policies<int>(scaled(64 << 20));
+    policies<Element<256>>(scaled(64 << 20));
+
+    header("growth_policies: push_back of 1024 ints into an empty Vector, many times");
+    short_lived<DefaultGrowth>("DefaultGrowth");
+    short_lived<DoublingGrowth>("DoublingGrowth");
+    short_lived<OneAndHalfGrowth>("OneAndHalfGrowth");
+}
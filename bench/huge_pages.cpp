@@ -0,0 +1,52 @@
+#include "bench.hpp"
+#include "../HugePageAllocator.hpp"
+
+#include <cstdint>
+
+
+namespace {
+
+// Random operator[] reads, the index stream is a xorshift so it costs no memory traffic
+template <typename A>
+void random_reads(const char* name, std::size_t bytes, std::size_t reads)
+{
+    typedef Vector<std::uint64_t, A> table_type;
+
+    table_type table;
+    table.reserve(bytes / sizeof(std::uint64_t));
+    for (std::size_t i = 0; i < bytes / sizeof(std::uint64_t); ++i)
+        table.push_back(i);
+
+    std::size_t mask = 1;
+    while (mask * 2 <= table.size())
+        mask *= 2;
+    --mask;
+
+    double seconds = bench::best_of(3, [&] {
+        std::uint64_t state = 88172645463325252ULL;
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < reads; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            sum += table[state & mask];
+        }
+        bench::keep(sum);
+    });
+    std::printf("%-18s %8.1f MiB  %6.2f ns per read\n", name, bytes / 1048576.0, seconds / reads * 1e9);
+}
+
+} // namespace
+
+// Huge pages only win when THP is enabled ("always" or "madvise" in
+// /sys/kernel/mm/transparent_hugepage/enabled)
+void bench::huge_pages()
+{
+    header("huge_pages: random operator[] reads over a lookup table");
+
+    std::size_t reads = scaled(20000000);
+    for (std::size_t bytes = scaled(16 << 20); bytes <= scaled(512 << 20); bytes *= 4) {
+        random_reads<VectorAllocator<std::uint64_t>>("VectorAllocator", bytes, reads);
+        random_reads<HugePageAllocator<std::uint64_t>>("HugePageAllocator", bytes, reads);
+    }
+}
@@ -0,0 +1,59 @@
+#include "bench.hpp"
+#include "../LockedAllocator.hpp"
+
+#include <cstdint>
+#include <new>
+
+
+namespace {
+
+struct Order {
+    std::uint64_t id;
+    double price;
+    char payload[48];
+};
+
+// Latency of every single push_back into capacity reserved up front
+template <typename A>
+void appends(const char* name, std::size_t count, bool populate)
+{
+    std::vector<double> samples;
+    samples.reserve(count);
+    try {
+        Vector<Order, A> orders;
+        if (populate)
+            orders.reserve_populated(count);
+        else
+            orders.reserve(count);
+
+        Order order = Order();
+        for (std::size_t i = 0; i < count; ++i) {
+            order.id = i;
+            bench::clock::time_point start = bench::clock::now();
+            orders.push_back(order);
+            samples.push_back(bench::seconds_since(start));
+        }
+        bench::keep(orders[count - 1]);
+    } catch (const std::bad_alloc&) {
+        std::printf("%-20s skipped, raise RLIMIT_MEMLOCK (ulimit -l)\n", name);
+        return;
+    }
+
+    double p50 = bench::percentile(samples, 0.5);
+    double p99 = bench::percentile(samples, 0.99);
+    double p999 = bench::percentile(samples, 0.999);
+    std::printf("%-20s p50 %6.0f ns  p99 %6.0f ns  p99.9 %7.0f ns  max %8.0f ns\n", name,
+                p50 * 1e9, p99 * 1e9, p999 * 1e9, samples.back() * 1e9);
+}
+
+} // namespace
+
+void bench::latency()
+{
+    header("latency: push_back into reserved capacity, 64 byte elements");
+
+    std::size_t count = scaled(16 << 20) / sizeof(Order);
+    appends<VectorAllocator<Order>>("reserve", count, false);
+    appends<VectorAllocator<Order>>("reserve_populated", count, true);
+    appends<LockedAllocator<Order>>("LockedAllocator", count, false);
+}
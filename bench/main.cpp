@@ -0,0 +1,50 @@
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+
+namespace bench {
+
+double scale = 1;
+
+} // namespace bench
+
+namespace {
+
+struct Benchmark {
+    const char* name;
+    void (*run)();
+};
+
+const Benchmark benchmarks[] = {
+    { "growth", bench::growth },
+    { "growth_policies", bench::growth_policies },
+    { "pool", bench::pool },
+    { "huge_pages", bench::huge_pages },
+    { "numa", bench::numa },
+    { "latency", bench::latency },
+};
+
+} // namespace
+
+// Usage: bench [--scale=FACTOR] [name...], runs every benchmark when no name is given
+int main(int argc, char* argv[])
+{
+    std::vector<const char*> selected;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--scale=", 8) == 0)
+            bench::scale = std::atof(argv[i] + 8);
+        else
+            selected.push_back(argv[i]);
+    }
+
+    for (const Benchmark& benchmark : benchmarks) {
+        bool run = selected.empty();
+        for (const char* name : selected)
+            run = run || std::strcmp(name, benchmark.name) == 0;
+        if (run)
+            benchmark.run();
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "bench.hpp"
+#include "../NumaAllocator.hpp"
+
+#include <thread>
+
+
+namespace {
+
+// Sums the Vector from thread_count threads with the static split parallel_append uses
+template <typename V>
+double read_bandwidth(const V& vec, unsigned thread_count)
+{
+    std::size_t count = vec.size();
+    std::vector<double> sums(thread_count);
+
+    double seconds = bench::best_of(5, [&] {
+        std::vector<std::thread> threads;
+        auto sum = [&](unsigned index) {
+            double total = 0;
+            for (std::size_t i = count * index / thread_count; i < count * (index + 1) / thread_count; ++i)
+                total += vec[i];
+            sums[index] = total;
+        };
+        for (unsigned i = 1; i < thread_count; ++i)
+            threads.emplace_back(sum, i);
+        sum(0);
+        for (std::thread& thread : threads)
+            thread.join();
+    });
+    bench::keep(sums[0]);
+    return count * sizeof(double) / seconds / 1e9;
+}
+
+void report(const char* name, double fill_seconds, double gigabytes_per_second)
+{
+    std::printf("%-34s fill %8.2f ms  read %6.2f GB/s\n", name, fill_seconds * 1e3, gigabytes_per_second);
+}
+
+} // namespace
+
+// On a single node machine all variants should perform alike, the policies are no-ops there
+void bench::numa()
+{
+    header("numa: fill and parallel read of a Vector<double>");
+
+    std::size_t count = scaled(256 << 20) / sizeof(double);
+    unsigned threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+    std::printf("%u nodes, %u threads\n", numa_detail::node_count(), threads);
+
+    {
+        clock::time_point start = clock::now();
+        Vector<double> vec(count, 1.0);
+        double fill = seconds_since(start);
+        report("single thread fill", fill, read_bandwidth(vec, threads));
+    }
+    {
+        clock::time_point start = clock::now();
+        Vector<double, NumaAllocator<double>> vec(NumaAllocator<double>(NumaPolicy::first_touch));
+        vec.reserve(count);
+        parallel_append(vec, count, 1.0, threads);
+        double fill = seconds_since(start);
+        report("parallel first-touch fill", fill, read_bandwidth(vec, threads));
+    }
+    {
+        clock::time_point start = clock::now();
+        Vector<double, NumaAllocator<double>> vec(NumaAllocator<double>(NumaPolicy::interleave));
+        vec.reserve(count);
+        parallel_append(vec, count, 1.0, threads);
+        double fill = seconds_since(start);
+        report("interleaved, parallel fill", fill, read_bandwidth(vec, threads));
+    }
+}
@@ -0,0 +1,62 @@
+#include "bench.hpp"
+#include "../PoolAllocator.hpp"
+
+#include <memory>
+#include <thread>
+
+
+namespace {
+
+// Builds and drops short-lived small Vectors, half grown by push_back, half reserved up front
+template <typename A>
+void churn(std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        int size = 1 + static_cast<int>(i % 64);
+
+        Vector<int, A> grown;
+        for (int j = 0; j < size; ++j)
+            grown.push_back(j);
+
+        Vector<int, A> reserved;
+        reserved.reserve(size);
+        for (int j = 0; j < size; ++j)
+            reserved.push_back_unchecked(j);
+
+        bench::keep(grown[0]);
+        bench::keep(reserved[0]);
+    }
+}
+
+template <typename A>
+void run(const char* name, unsigned thread_count, std::size_t count)
+{
+    double seconds = bench::best_of(3, [&] {
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < thread_count; ++i)
+            threads.emplace_back(churn<A>, count);
+        for (std::thread& thread : threads)
+            thread.join();
+    });
+    std::printf("%-16s %2u threads  %8.2f ns per Vector pair\n", name, thread_count,
+                seconds / (count * thread_count) * 1e9);
+}
+
+} // namespace
+
+void bench::pool()
+{
+    header("pool: short-lived Vectors of 1..64 ints");
+
+    std::size_t count = scaled(1000000);
+    unsigned threads = std::thread::hardware_concurrency();
+    if (threads < 4)
+        threads = 4; // contention shows even when threads share cores
+
+    run<PoolAllocator<int>>("PoolAllocator", 1, count);
+    run<std::allocator<int>>("std::allocator", 1, count);
+    run<VectorAllocator<int>>("VectorAllocator", 1, count);
+    run<PoolAllocator<int>>("PoolAllocator", threads, count / threads);
+    run<std::allocator<int>>("std::allocator", threads, count / threads);
+    run<VectorAllocator<int>>("VectorAllocator", threads, count / threads);
+}
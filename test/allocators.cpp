@@ -0,0 +1,325 @@
+#include "../Vector.hpp"
+#include "../AlignedAllocator.hpp"
+#include "../ArenaAllocator.hpp"
+#include "../PoolAllocator.hpp"
+#include "../HugePageAllocator.hpp"
+#include "../LockedAllocator.hpp"
+#include "../NumaAllocator.hpp"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+
+// Stateful allocator, instances with different ids can't free each other's memory
+template <typename T>
+struct TaggedAllocator {
+    typedef T value_type;
+
+    int id;
+
+    TaggedAllocator(int id) : id(id) {}
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U>& rhs) : id(rhs.id) {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(::operator new(n * sizeof(T))); }
+    void deallocate(T* p, std::size_t) { ::operator delete(p); }
+};
+
+template <typename T, typename U>
+bool operator ==(const TaggedAllocator<T>& lhs, const TaggedAllocator<U>& rhs) { return lhs.id == rhs.id; }
+
+template <typename T, typename U>
+bool operator !=(const TaggedAllocator<T>& lhs, const TaggedAllocator<U>& rhs) { return lhs.id != rhs.id; }
+
+
+TEST_CASE("stateful allocator test", "[allocator]")
+{
+    typedef Vector<std::string, TaggedAllocator<std::string>> vector_type;
+
+    vector_type first(TaggedAllocator<std::string>(1));
+    first.push_back("abc");
+    vector_type second(3, "def", TaggedAllocator<std::string>(2));
+
+    vector_type copy(first);
+    REQUIRE(copy.get_allocator().id == 1);
+    REQUIRE(copy[0] == "abc");
+
+    // Allocators don't propagate on assignment, each Vector keeps its own
+    second = first;
+    REQUIRE(second.get_allocator().id == 2);
+    REQUIRE(second.size() == 1);
+    REQUIRE(second[0] == "abc");
+
+    second = std::move(copy);
+    REQUIRE(second.get_allocator().id == 2);
+    REQUIRE(second[0] == "abc");
+
+    vector_type moved(std::move(first), TaggedAllocator<std::string>(3));
+    REQUIRE(moved.get_allocator().id == 3);
+    REQUIRE(moved[0] == "abc");
+}
+
+#if __cplusplus >= 201703L
+TEST_CASE("polymorphic allocator test", "[allocator][pmr]")
+{
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    Vector<int, std::pmr::polymorphic_allocator<int>> vec(&resource);
+    for (int i = 0; i < 100; ++i)
+        vec.push_back(i);
+
+    REQUIRE(vec.get_allocator().resource() == &resource);
+    REQUIRE(static_cast<void*>(&vec[0]) >= static_cast<void*>(buffer));
+    REQUIRE(static_cast<void*>(&vec[99]) < static_cast<void*>(buffer + sizeof(buffer)));
+}
+#endif
+
+TEST_CASE("arena allocator test", "[allocator][arena]")
+{
+    MonotonicArena arena(1024 * 1024);
+
+    {
+        Vector<long, ArenaAllocator<long>> vec(arena);
+        vec.push_back(0);
+        long* data = &vec[0];
+
+        for (long i = 1; i < 10000; ++i)
+            vec.push_back(i);
+
+        REQUIRE(&vec[0] == data); // grew in place at the top of the arena
+        REQUIRE(vec[9999] == 9999);
+
+        Vector<std::string, ArenaAllocator<std::string>> strings(arena);
+        for (int i = 0; i < 100; ++i)
+            strings.push_back(std::to_string(i));
+        REQUIRE(strings[99] == "99");
+        REQUIRE(arena.used() >= 10000 * sizeof(long));
+    }
+
+    REQUIRE(arena.used() == 0); // Vectors died in LIFO order, each rewound the arena
+
+    ArenaAllocator<int> ints(arena);
+    int* first = ints.allocate(10);
+    int* second = ints.allocate(10);
+    ints.deallocate(first, 10); // not on top, memory stays until reset
+    REQUIRE(arena.used() >= 20 * sizeof(int));
+    arena.reset();
+    REQUIRE(arena.used() == 0);
+    (void)second;
+
+    // Allocations bigger than a chunk get a chunk of their own
+    ArenaAllocator<char> allocator(arena);
+    char* big = allocator.allocate(4 * 1024 * 1024);
+    big[4 * 1024 * 1024 - 1] = 'x';
+    allocator.deallocate(big, 4 * 1024 * 1024);
+}
+
+TEST_CASE("pool allocator test", "[allocator][pool]")
+{
+    Vector<int, PoolAllocator<int>> vec;
+    vec.push_back(1);
+    REQUIRE(vec.capacity() == 16); // whole 64 B size class
+
+    for (int i = 1; i < 100000; ++i)
+        vec.push_back(i);
+    REQUIRE(vec[99999] == 99999);
+
+    // Blocks freed by another thread travel back through the depot in batches
+    PoolAllocator<std::string> allocator;
+    std::vector<std::string*> blocks;
+    for (int i = 0; i < 1000; ++i)
+        blocks.push_back(allocator.allocate(2));
+
+    std::thread([&] {
+        for (std::string* block : blocks)
+            allocator.deallocate(block, 2);
+    }).join();
+
+    Vector<Vector<std::string, PoolAllocator<std::string>>> nested;
+    for (int i = 0; i < 1000; ++i) {
+        nested.emplace_back();
+        nested.back().push_back(std::to_string(i));
+    }
+    REQUIRE(nested[999][0] == "999");
+}
+
+TEST_CASE("pool allocator test - freeing thread exits", "[allocator][pool]")
+{
+    // Fewer blocks than the freeing thread hands back by itself, all of them stay in its cache
+    PoolAllocator<char> allocator;
+    const std::size_t size = 3000; // 4 KiB size class
+    std::vector<char*> blocks;
+    for (int i = 0; i < 40; ++i)
+        blocks.push_back(allocator.allocate(size));
+
+    std::thread([&] {
+        for (char* block : blocks)
+            allocator.deallocate(block, size);
+    }).join();
+
+    // Its exit returned them to the depot, where a new thread's first batch comes from
+    std::vector<char*> reused;
+    std::thread([&] {
+        for (int i = 0; i < 40; ++i)
+            reused.push_back(allocator.allocate(size));
+        for (char* block : reused)
+            allocator.deallocate(block, size);
+    }).join();
+
+    bool all_returned = true;
+    for (char* block : reused)
+        all_returned = all_returned && std::find(blocks.begin(), blocks.end(), block) != blocks.end();
+    REQUIRE(all_returned);
+}
+
+TEST_CASE("huge page allocator test", "[allocator][huge_page]")
+{
+    typedef HugePageAllocator<long> allocator_type;
+    const std::size_t huge = allocator_type::huge_page_size / sizeof(long);
+
+    Vector<long, allocator_type> small;
+    small.push_back(1);
+    REQUIRE(small.capacity() < huge);
+
+    Vector<long, allocator_type> table;
+    table.reserve(huge + 1);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&table[0]) % allocator_type::huge_page_size == 0);
+    REQUIRE(table.capacity() == 2 * huge); // whole huge pages
+
+    for (std::size_t i = 0; i < 3 * huge; ++i)
+        table.push_back(i);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&table[0]) % allocator_type::huge_page_size == 0);
+    REQUIRE(table[3 * huge - 1] == long(3 * huge - 1));
+}
+
+// Throws on the n-th copy, to check parallel_append cleans up after a failing thread
+struct ThrowingCopy {
+    static std::atomic<int> copies_left;
+    static std::atomic<int> alive;
+
+    ThrowingCopy() { ++alive; }
+    ThrowingCopy(const ThrowingCopy&)
+    {
+        if (copies_left-- == 0)
+            throw std::runtime_error("copy");
+        ++alive;
+    }
+    ~ThrowingCopy() { --alive; }
+};
+
+std::atomic<int> ThrowingCopy::copies_left(0);
+std::atomic<int> ThrowingCopy::alive(0);
+
+TEST_CASE("numa allocator test", "[allocator][numa]")
+{
+    // Policies degrade to plain mappings where mbind() isn't available or there is one node
+    Vector<int, NumaAllocator<int>> interleaved(NumaAllocator<int>(NumaPolicy::interleave));
+    for (int i = 0; i < 100000; ++i)
+        interleaved.push_back(i);
+    REQUIRE(interleaved[99999] == 99999);
+
+    Vector<int, NumaAllocator<int>> bound(NumaAllocator<int>(NumaPolicy::bind, 1));
+    bound.reserve(100000);
+    REQUIRE(bound.capacity() * sizeof(int) % 4096 == 0); // whole pages
+    bound = interleaved;
+    REQUIRE(bound.size() == 100000);
+    REQUIRE(bound[99999] == 99999);
+
+    Vector<std::string, NumaAllocator<std::string>> strings(NumaAllocator<std::string>(NumaPolicy::first_touch));
+    strings.push_back("first");
+    parallel_append(strings, 10000, std::string("value"), 4);
+    REQUIRE(strings.size() == 10001);
+    REQUIRE(strings[0] == "first");
+    bool all_equal = true;
+    for (std::size_t i = 1; i < strings.size(); ++i)
+        all_equal = all_equal && strings[i] == "value";
+    REQUIRE(all_equal);
+
+    // Elements bigger than a page: only non-empty blocks are mappings
+    struct Page {
+        char bytes[8192];
+    };
+    NumaAllocator<Page> page_allocator;
+    page_allocator.deallocate(page_allocator.allocate(0), 0);
+    Vector<Page, NumaAllocator<Page>> pages(0);
+    pages.reserve(2);
+    REQUIRE(pages.capacity() == 2);
+
+    Vector<ThrowingCopy> throwing;
+    {
+        ThrowingCopy value;
+        ThrowingCopy::copies_left = 500;
+        REQUIRE_THROWS(parallel_append(throwing, 1000, value, 3));
+        REQUIRE(throwing.size() == 0);
+        REQUIRE(ThrowingCopy::alive == 1);
+    }
+}
+
+TEST_CASE("locked allocator test", "[allocator][locked]")
+{
+    // Stays well below the usual 64 KiB - 8 MiB RLIMIT_MEMLOCK
+    Vector<int, LockedAllocator<int>> vec;
+    vec.push_back(1);
+    REQUIRE(vec.capacity() * sizeof(int) % 4096 == 0); // whole pages
+    vec.reserve_populated(4096);
+    for (int i = 1; i < 8192; ++i)
+        vec.push_back(i);
+    REQUIRE(vec[8191] == 8191);
+
+    Vector<std::string, LockedAllocator<std::string>> strings;
+    for (int i = 0; i < 100; ++i)
+        strings.push_back(std::to_string(i));
+    REQUIRE(strings[99] == "99");
+}
+
+struct alignas(64) CacheLine {
+    int value;
+};
+
+TEST_CASE("aligned allocator test", "[allocator][aligned]")
+{
+    AlignedVector<float, 32> floats;
+    bool aligned = true;
+    for (int i = 0; i < 10000; ++i) {
+        floats.push_back(float(i));
+        aligned = aligned && reinterpret_cast<std::uintptr_t>(&floats[0]) % 32 == 0;
+    }
+    REQUIRE(aligned);
+    REQUIRE(floats[9999] == 9999.0f);
+
+    AlignedVector<float> odd;
+    odd.reserve(3);
+    REQUIRE(odd.capacity() == 16); // one whole 64 byte vector
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&odd.begin()[0]) % 64 == 0);
+
+    AlignedVector<CacheLine> lines;
+    for (int i = 0; i < 100; ++i)
+        lines.push_back(CacheLine{ i });
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&lines[1]) % 64 == 0);
+    REQUIRE(lines[99].value == 99);
+}
+
+TEST_CASE("default allocator test - over-aligned types", "[allocator][aligned]")
+{
+    static_assert(std::is_same<Vector<int>::allocator_type, VectorAllocator<int>>::value,
+                  "ordinary types use VectorAllocator");
+    static_assert(std::is_same<Vector<CacheLine>::allocator_type, AlignedAllocator<CacheLine, 64>>::value,
+                  "over-aligned types use AlignedAllocator");
+
+    Vector<CacheLine> lines;
+    for (int i = 0; i < 100; ++i)
+        lines.push_back(CacheLine{ i });
+    REQUIRE(lines[99].value == 99);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&lines[0]) % 64 == 0);
+}
@@ -0,0 +1,46 @@
+#include "../CompactVector.hpp"
+#include "catch.hpp"
+
+#include <cstdint>
+#include <string>
+
+
+static_assert(sizeof(void*) != 8 || sizeof(CompactVector<int>) == 16, "pointer plus two 32-bit counters");
+static_assert(sizeof(Vector<int>) == 3 * sizeof(void*), "stateless allocators take no room");
+
+// The allocator is a member, not a base, so its name isn't hidden in classes derived from Vector
+struct DerivedVector : Vector<int> {
+    VectorAllocator<int> heap() const { return VectorAllocator<int>(); }
+};
+
+
+TEST_CASE("compact vector test", "[compact_vector]")
+{
+    CompactVector<CompactVector<int>> adjacency;
+    adjacency.resize(100);
+    for (int i = 0; i < 100; ++i)
+        for (int j = 0; j < i % 7; ++j)
+            adjacency[i].push_back(j);
+    REQUIRE(adjacency[6].size() == 6);
+    REQUIRE(adjacency[6][5] == 5);
+    REQUIRE(adjacency[7].empty());
+
+    CompactVector<std::string> strings;
+    for (int i = 0; i < 1000; ++i)
+        strings.push_back(std::to_string(i));
+    REQUIRE(strings[999] == "999");
+
+    CompactVector<int> ints;
+    REQUIRE(ints.max_size() == UINT32_MAX / sizeof(int));
+    REQUIRE_THROWS(ints.resize(ints.max_size() + 1));
+
+    // _size + count would wrap around in 32 bits
+    CompactVector<char> chars;
+    chars.push_back('a');
+    REQUIRE_THROWS(chars.append_with(chars.max_size(), [](char*) {}));
+    REQUIRE(chars.size() == 1);
+
+    DerivedVector derived;
+    derived.push_back(1);
+    REQUIRE(derived.heap() == derived.get_allocator());
+}
@@ -0,0 +1,174 @@
+#include "../CowVector.hpp"
+#include "../ArenaAllocator.hpp"
+#include "catch.hpp"
+
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+// Detects whether a string literal can be assigned through what Get returns
+template <typename Get, typename = void>
+struct is_writable : std::false_type {};
+
+template <typename Get>
+struct is_writable<Get, decltype(void(std::declval<Get>()() = "changed"))> : std::true_type {};
+
+struct SnapshotFront {
+    auto operator ()() const -> decltype(std::declval<const CowVector<std::string>&>().vector().front());
+};
+
+struct SnapshotBegin {
+    auto operator ()() const -> decltype(*std::declval<const CowVector<std::string>&>().vector().begin());
+};
+
+struct SnapshotIndex {
+    auto operator ()() const -> decltype(std::declval<const CowVector<std::string>&>().vector()[0]);
+};
+
+struct VectorFront {
+    auto operator ()() const -> decltype(std::declval<Vector<std::string>&>().front());
+};
+
+} // namespace
+
+
+TEST_CASE("cow vector test - sharing", "[cow_vector]")
+{
+    CowVector<std::string> config;
+    REQUIRE(config.empty());
+    REQUIRE(!config.is_shared());
+    for (int i = 0; i < 100; ++i)
+        config.push_back(std::to_string(i));
+
+    CowVector<std::string> snapshot(config);
+    CowVector<std::string> another = snapshot;
+    REQUIRE(config.is_shared());
+    REQUIRE(snapshot.cbegin() == config.cbegin()); // same buffer, no copy
+    REQUIRE(another.vector()[99] == "99"); // const access, still shared
+
+    config.push_back("100"); // detaches
+    REQUIRE(config.size() == 101);
+    REQUIRE(snapshot.size() == 100);
+    REQUIRE(!config.is_shared());
+    REQUIRE(snapshot.is_shared());
+    REQUIRE(snapshot.cbegin() == another.cbegin());
+
+    another.erase(another.cbegin() + 1, another.cend()); // positions from the shared buffer
+    REQUIRE(another.size() == 1);
+    REQUIRE(snapshot.size() == 100);
+    another.insert(another.cbegin(), snapshot.vector()[99]);
+    REQUIRE(another[0] == "99");
+    REQUIRE(!snapshot.is_shared());
+
+    const std::string* before = snapshot.cbegin();
+    snapshot.pop_back(); // sole owner, no copy
+    REQUIRE(snapshot.cbegin() == before);
+
+    CowVector<std::string> cleared(config);
+    cleared.clear();
+    REQUIRE(cleared.empty());
+    REQUIRE(config.size() == 101);
+
+    CowVector<std::string> assigned(config);
+    assigned.assign(3, "x");
+    REQUIRE(assigned.size() == 3);
+    REQUIRE(config[0] == "0");
+}
+
+TEST_CASE("cow vector test - leaked references", "[cow_vector]")
+{
+    CowVector<int> vec(10, 1);
+    int& first = vec[0]; // leaks the buffer, later copies are deep
+    CowVector<int> copy(vec);
+    first = 2;
+    REQUIRE(copy[0] == 1);
+    REQUIRE(!vec.is_shared());
+
+    CowVector<int> shared(copy);
+    Vector<int>& mutable_vector = shared.mutate();
+    mutable_vector.push_back(3);
+    REQUIRE(shared.size() == 11);
+    REQUIRE(copy.size() == 10);
+
+    // Copies are released concurrently, the last one frees the buffer
+    CowVector<std::string> source(Vector<std::string>(1000, "value"));
+    std::thread threads[4];
+    for (std::thread& thread : threads) {
+        CowVector<std::string> local(source);
+        thread = std::thread([](CowVector<std::string> snapshot) {
+            for (int i = 0; i < 100; ++i) {
+                CowVector<std::string> copy(snapshot);
+                copy.push_back("more");
+            }
+        }, std::move(local));
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    REQUIRE(!source.is_shared());
+    REQUIRE(source.size() == 1000);
+}
+
+TEST_CASE("cow vector test - const snapshot", "[cow_vector]")
+{
+    // A const snapshot hands out nothing that can be written through
+    static_assert(!is_writable<SnapshotFront>::value, "front() of a const snapshot must be read-only");
+    static_assert(!is_writable<SnapshotBegin>::value, "begin() of a const snapshot must be read-only");
+    static_assert(!is_writable<SnapshotIndex>::value, "operator[] of a const snapshot must be read-only");
+    static_assert(is_writable<VectorFront>::value, "front() of a mutable Vector stays writable");
+    static_assert(std::is_same<Vector<int>::const_iterator,
+                               decltype(std::declval<const Vector<int>&>().begin())>::value,
+                  "const begin() returns a const_iterator");
+    static_assert(std::is_same<Vector<int>::const_reference,
+                               decltype(std::declval<const Vector<int>&>().cback())>::value,
+                  "cback() returns a const_reference");
+
+    CowVector<std::string> config(Vector<std::string>(3, "value"));
+    const CowVector<std::string> snapshot(config);
+    REQUIRE(&snapshot.front() == &snapshot.vector().cfront());
+    REQUIRE(&snapshot.back() == &snapshot.vector().cback());
+    REQUIRE(snapshot.begin() == snapshot.vector().cbegin());
+    REQUIRE(snapshot.end() == snapshot.vector().cend());
+    REQUIRE(snapshot.vector().crbegin()->size() == 5);
+    REQUIRE(config.is_shared()); // const access does not leak the buffer
+
+    const CowVector<int> empty;
+    REQUIRE(empty.begin() == empty.end());
+}
+
+TEST_CASE("cow vector test - stateful allocator", "[cow_vector]")
+{
+    // ArenaAllocator has no default constructor, so CowVector has to use the one it was given
+    MonotonicArena arena(64 * 1024);
+    typedef CowVector<long, ArenaAllocator<long>> vector_type;
+
+    const vector_type empty((ArenaAllocator<long>(arena)));
+    REQUIRE(empty.begin() == empty.end());
+    REQUIRE(empty.size() == 0);
+    REQUIRE(empty.vector().empty());
+    REQUIRE(empty.vector().get_allocator() == ArenaAllocator<long>(arena));
+
+    vector_type vec((ArenaAllocator<long>(arena)));
+    for (long i = 0; i < 100; ++i)
+        vec.push_back(i);
+    REQUIRE(arena.used() >= 100 * sizeof(long));
+
+    const vector_type snapshot(vec);
+    REQUIRE(snapshot.front() == 0);
+    REQUIRE(snapshot.back() == 99);
+    REQUIRE(vec.is_shared());
+
+    vec.clear(); // lets go of the shared buffer, keeps the allocator
+    REQUIRE(vec.get_allocator() == ArenaAllocator<long>(arena));
+    vec.push_back(7);
+    REQUIRE(vec.front() == 7);
+    REQUIRE(snapshot.size() == 100);
+
+    vector_type moved(std::move(vec));
+    vec = moved;
+    vec.assign(3, 1L);
+    REQUIRE(vec.size() == 3);
+    REQUIRE(moved.size() == 1);
+}
@@ -0,0 +1,144 @@
+#include "../InplaceVector.hpp"
+#include "catch.hpp"
+
+#include <new>
+#include <string>
+#include <type_traits>
+
+
+static_assert(std::is_trivially_copyable<InplaceVector<int, 16>>::value, "trivial elements keep InplaceVector trivially copyable");
+static_assert(!std::is_trivially_copyable<InplaceVector<std::string, 16>>::value, "strings need real copies");
+
+struct Point {
+    int x = 0;
+    int y = 0;
+};
+
+struct Span {
+    Span(int first, int last) : first(first), last(last) {} // no default constructor
+
+    int first;
+    int last;
+};
+
+static_assert(std::is_trivially_copyable<InplaceVector<Point, 8>>::value, "trivially copyable elements, not only trivial ones");
+static_assert(std::is_trivially_copyable<InplaceVector<Span, 8>>::value, "elements are never default constructed");
+
+constexpr InplaceVector<int, 4> empty_vector(inplace_constant_init);
+static_assert(empty_vector.empty() && empty_vector.capacity() == 4, "usable in constant expressions");
+#if defined(__cpp_lib_is_constant_evaluated)
+static_assert(InplaceVector<int, 4>().empty(), "C++20 zeroes only during constant evaluation, no tag needed");
+#endif
+
+#if __cplusplus >= 201402L
+constexpr int constexpr_sum()
+{
+    InplaceVector<int, 8> vec(inplace_constant_init);
+    for (int i = 1; i <= 5; ++i)
+        vec.push_back(i);
+    vec.erase(vec.begin());
+    vec.insert(vec.begin() + 1, 10);
+
+    int sum = 0;
+    for (int value : vec)
+        sum += value;
+    return sum;
+}
+
+static_assert(constexpr_sum() == 24, "mutating members are constexpr since C++14");
+#endif
+
+
+TEST_CASE("inplace vector test - trivial elements", "[inplace_vector]")
+{
+    InplaceVector<int, 8> vec;
+    for (int i = 0; i < 8; ++i)
+        vec.push_back(i);
+    REQUIRE(vec.size() == 8);
+    REQUIRE_THROWS(vec.push_back(8));
+    REQUIRE_THROWS(vec.reserve(9));
+
+    InplaceVector<int, 8> copy = vec;
+    REQUIRE(copy[7] == 7);
+
+    REQUIRE(vec.erase_if([](int value) { return value % 2 == 0; }) == 4);
+    REQUIRE(vec.size() == 4);
+    REQUIRE(vec[0] == 1);
+    vec.unordered_erase(vec.begin());
+    REQUIRE(vec[0] == 7);
+    vec.insert(vec.begin(), vec.back());
+    REQUIRE(vec[0] == 5);
+    vec.resize(6);
+    REQUIRE(vec[5] == 0);
+
+    InplaceVector<int, 8> listed = { 3, 2, 1 };
+    swap(listed, copy);
+    REQUIRE(listed.size() == 8);
+    REQUIRE(copy.size() == 3);
+    REQUIRE(*copy.rbegin() == 1);
+
+    // Const members match Vector's, so code written against either compiles with both
+    const InplaceVector<int, 8>& view = copy;
+    REQUIRE(view.front() == 3);
+    REQUIRE(view.back() == 1);
+    REQUIRE(*view.rbegin() == 1);
+    REQUIRE(*(view.rend() - 1) == 3);
+    static_assert(std::is_same<decltype(view.front()), const int&>::value, "const front() is read-only");
+    static_assert(std::is_same<decltype(view.rbegin()), InplaceVector<int, 8>::const_reverse_iterator>::value,
+                  "const rbegin() is read-only");
+
+    InplaceVector<int, 8> zeroed(inplace_constant_init);
+    REQUIRE(zeroed.empty());
+}
+
+TEST_CASE("inplace vector test - trivially copyable elements", "[inplace_vector]")
+{
+    InplaceVector<Span, 4> spans;
+    spans.emplace_back(1, 2);
+    spans.emplace_back(3, 4);
+
+    InplaceVector<Span, 4> copy = spans;
+    spans.erase(spans.begin());
+    REQUIRE(spans.size() == 1);
+    REQUIRE(spans[0].first == 3);
+    REQUIRE(copy.size() == 2);
+    REQUIRE(copy[0].last == 2);
+
+    InplaceVector<Point, 4> points;
+    points.resize(2);
+    points[1].y = 5;
+    InplaceVector<Point, 4> assigned;
+    assigned = points;
+    REQUIRE(assigned.size() == 2);
+    REQUIRE(assigned[0].x == 0);
+    REQUIRE(assigned[1].y == 5);
+}
+
+TEST_CASE("inplace vector test - non-trivial elements", "[inplace_vector]")
+{
+    InplaceVector<std::string, 4> vec(2, "value");
+    vec.emplace_back(3, 'x');
+    REQUIRE(vec.back() == "xxx");
+
+    InplaceVector<std::string, 4> copy(vec);
+    InplaceVector<std::string, 4> moved(std::move(copy));
+    REQUIRE(moved.size() == 3);
+    REQUIRE(moved[2] == "xxx");
+
+    InplaceVector<std::string, 4> other = { "a" };
+    other = moved;
+    REQUIRE(other.size() == 3);
+    moved = InplaceVector<std::string, 4>(1, "b");
+    REQUIRE(moved.size() == 1);
+
+    other.insert(other.begin() + 1, other[0]);
+    REQUIRE(other[1] == "value");
+    REQUIRE(other[3] == "xxx");
+    other.erase(other.begin(), other.begin() + 2);
+    REQUIRE(other[0] == "value");
+    other.swap(moved);
+    REQUIRE(other[0] == "b");
+    REQUIRE(moved.size() == 2);
+    moved.clear();
+    REQUIRE(moved.empty());
+}
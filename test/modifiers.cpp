@@ -0,0 +1,451 @@
+#include "../Vector.hpp"
+#include "catch.hpp"
+
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+struct Counted {
+    static int copies;
+    static int moves;
+
+    std::string value;
+
+    Counted(const std::string& value) : value(value) {}
+    Counted(const char* first, std::size_t count) : value(first, count) {}
+    Counted(const Counted& rhs) : value(rhs.value) { ++copies; }
+    Counted(Counted&& rhs) noexcept : value(std::move(rhs.value)) { ++moves; }
+};
+
+int Counted::copies = 0;
+int Counted::moves = 0;
+
+// Forward iterator yielding squares by value, like a transform iterator
+struct SquareIterator {
+    typedef std::forward_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const int* pointer;
+    typedef int reference;
+
+    int current;
+
+    int operator *() const { return current * current; }
+    SquareIterator& operator ++() { ++current; return *this; }
+    SquareIterator operator ++(int) { SquareIterator old = *this; ++current; return old; }
+    bool operator ==(const SquareIterator& rhs) const { return current == rhs.current; }
+    bool operator !=(const SquareIterator& rhs) const { return current != rhs.current; }
+};
+
+
+TEST_CASE("push_back test - r-value", "[push_back][move]")
+{
+    Counted::copies = 0;
+
+    Vector<Counted> vec;
+    for (int i = 0; i < 100; ++i)
+        vec.push_back(Counted(std::to_string(i)));
+
+    REQUIRE(Counted::copies == 0);
+    REQUIRE(vec.size() == 100);
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(vec[i].value == std::to_string(i));
+}
+
+TEST_CASE("emplace_back test", "[emplace_back]")
+{
+    Counted::copies = 0;
+    Counted::moves = 0;
+
+    Vector<Counted> vec;
+    vec.reserve(2);
+    Counted& first = vec.emplace_back("abcdef", 3);
+
+    REQUIRE(first.value == "abc");
+    REQUIRE(Counted::copies == 0);
+    REQUIRE(Counted::moves == 0);
+
+    // Value aliasing an element survives the reallocation it triggers
+    Vector<std::string> strings;
+    strings.push_back(std::string(100, 'x'));
+    while (strings.size() < strings.capacity())
+        strings.push_back("filler");
+    strings.push_back(strings[0]);
+
+    REQUIRE(strings.back() == std::string(100, 'x'));
+}
+
+TEST_CASE("move assignment test", "[operator=][move]")
+{
+    Vector<std::string> vec(3, "abc");
+    Vector<std::string> other(5, "def");
+
+    other = std::move(vec);
+
+    REQUIRE(vec.size() == 0);
+    REQUIRE(other.size() == 3);
+    REQUIRE(other[2] == "abc");
+}
+
+TEST_CASE("append test", "[append]")
+{
+    std::vector<int> source = {1, 2, 3, 4, 5};
+
+    Vector<int> vec;
+    vec.append(source.begin(), source.end());
+    vec.append(vec);
+
+    REQUIRE(vec.size() == 10);
+    for (int i = 0; i < 10; ++i)
+        REQUIRE(vec[i] == i % 5 + 1);
+
+    std::istringstream stream("7 8 9");
+    vec.append(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+
+    REQUIRE(vec.size() == 13);
+    REQUIRE(vec.back() == 9);
+}
+
+TEST_CASE("append test - move and proxy iterators", "[append][insert]")
+{
+    std::vector<std::string> source = {"a", "b", "c"};
+    Vector<std::string> strings(1, "x");
+    strings.append(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+    strings.insert(strings.begin(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.begin() + 1));
+
+    REQUIRE(strings.size() == 5);
+    REQUIRE(strings[1] == "x");
+    REQUIRE(strings[2] == "a");
+    REQUIRE(strings[4] == "c");
+    REQUIRE(source[2].empty());
+
+    std::vector<bool> bits = {true, false, true};
+    Vector<bool> flags;
+    flags.append(bits.begin(), bits.end());
+    flags.insert(flags.begin() + 1, bits.begin(), bits.begin() + 1);
+    REQUIRE(flags.size() == 4);
+    REQUIRE(flags[1]);
+    REQUIRE(!flags[2]);
+
+    Vector<int> squares;
+    squares.append(SquareIterator{1}, SquareIterator{4});
+    squares.insert(squares.begin(), SquareIterator{4}, SquareIterator{6});
+    int expected[] = {16, 25, 1, 4, 9};
+    REQUIRE(squares.size() == 5);
+    for (int i = 0; i < 5; ++i)
+        REQUIRE(squares[i] == expected[i]);
+}
+
+TEST_CASE("insert test - range", "[insert]")
+{
+    Vector<int> vec(4, 0);
+    int values[] = {1, 2, 3};
+
+    Vector<int>::iterator it = vec.insert(vec.begin() + 2, values, values + 3);
+    REQUIRE(*it == 1);
+    vec.insert(vec.end(), values, values + 1);
+    vec.insert(vec.begin(), vec.begin() + 2, vec.begin() + 4);
+
+    int expected[] = {1, 2, 0, 0, 1, 2, 3, 0, 0, 1};
+    REQUIRE(vec.size() == 10);
+    for (int i = 0; i < 10; ++i)
+        REQUIRE(vec[i] == expected[i]);
+
+    Vector<std::string> strings(2, "b");
+    std::string words[] = {"a", "c"};
+    strings.insert(strings.begin(), words, words + 1);
+    strings.insert(strings.end(), words + 1, words + 2);
+    strings.insert(strings.begin() + 1, strings[3]);
+
+    REQUIRE(strings.size() == 5);
+    REQUIRE(strings[0] == "a");
+    REQUIRE(strings[1] == "c");
+    REQUIRE(strings[2] == "b");
+    REQUIRE(strings[4] == "c");
+}
+
+TEST_CASE("resize test", "[resize]")
+{
+    Vector<std::string> strings(2, "a");
+    strings.resize(5, "b");
+    REQUIRE(strings.size() == 5);
+    REQUIRE(strings[1] == "a");
+    REQUIRE(strings[4] == "b");
+
+    strings.resize(1);
+    REQUIRE(strings.size() == 1);
+    strings.resize(3);
+    REQUIRE(strings[2].empty());
+
+    Vector<int> vec;
+    vec.resize(100);
+    REQUIRE(vec[99] == 0);
+
+    vec.resize_uninitialized(1000);
+    REQUIRE(vec.size() == 1000);
+    REQUIRE(vec[99] == 0);
+    vec.resize_default_init(10);
+    REQUIRE(vec.size() == 10);
+}
+
+TEST_CASE("append_with test", "[append_with]")
+{
+    Vector<char> buffer;
+    buffer.append_with(3, [](char* dest) {
+        std::memcpy(dest, "abc", 3);
+    });
+    buffer.append_with(100, [](char* dest) -> std::size_t {
+        std::memcpy(dest, "de", 2);
+        return 2;
+    });
+
+    REQUIRE(buffer.size() == 5);
+    REQUIRE(std::string(buffer.begin(), buffer.end()) == "abcde");
+}
+
+TEST_CASE("push_back test - unchecked", "[push_back][unchecked]")
+{
+    Vector<int> vec;
+    vec.reserve(3);
+    vec.push_back_unchecked(1);
+    vec.emplace_back_unchecked(2);
+
+    REQUIRE(vec.size() == 2);
+    REQUIRE(vec[1] == 2);
+
+    {
+        Vector<int>::bulk_writer writer(vec, 1000);
+        for (int i = 0; i < 1000; ++i)
+            writer.push_back(i);
+
+        REQUIRE(vec.size() == 2); // size is committed when the writer goes away
+    }
+
+    REQUIRE(vec.size() == 1002);
+    REQUIRE(vec.capacity() >= 1002);
+    REQUIRE(vec[1001] == 999);
+}
+
+TEST_CASE("clear test", "[clear][shrink_to_fit]")
+{
+    Vector<std::string> strings(100, "abc");
+    std::size_t capacity = strings.capacity();
+
+    strings.clear();
+    REQUIRE(strings.size() == 0);
+    REQUIRE(strings.capacity() == capacity);
+
+    strings.push_back("def");
+    strings.shrink_to_fit();
+    REQUIRE(strings.capacity() >= 1);
+    REQUIRE(strings.capacity() < capacity);
+    REQUIRE(strings[0] == "def");
+
+    Vector<int> vec(1000, 7);
+    vec.resize(10);
+    vec.shrink_to_fit();
+    REQUIRE(vec.capacity() >= 10);
+    REQUIRE(vec.capacity() < 1000);
+    REQUIRE(vec[9] == 7);
+
+    vec.release_memory();
+    REQUIRE(vec.size() == 0);
+    REQUIRE(vec.capacity() == 0);
+}
+
+TEST_CASE("erase test", "[erase]")
+{
+    Vector<int> vec;
+    for (int i = 0; i < 10; ++i)
+        vec.push_back(i);
+
+    Vector<int>::iterator it = vec.erase(vec.begin() + 2, vec.begin() + 5);
+    REQUIRE(*it == 5);
+    vec.erase(vec.begin());
+    vec.pop_back();
+
+    int expected[] = {1, 5, 6, 7, 8};
+    REQUIRE(vec.size() == 5);
+    for (int i = 0; i < 5; ++i)
+        REQUIRE(vec[i] == expected[i]);
+
+    Vector<std::string> strings;
+    for (int i = 0; i < 5; ++i)
+        strings.push_back(std::to_string(i));
+    strings.erase(strings.begin() + 1, strings.begin() + 3);
+
+    REQUIRE(strings.size() == 3);
+    REQUIRE(strings[1] == "3");
+}
+
+TEST_CASE("erase_if test", "[erase][erase_if]")
+{
+    Vector<int> vec;
+    for (int i = 0; i < 100; ++i)
+        vec.push_back(i);
+
+    REQUIRE(vec.erase_if([](int x) { return x % 3 != 0; }) == 66);
+    REQUIRE(vec.size() == 34);
+    for (int i = 0; i < 34; ++i)
+        REQUIRE(vec[i] == 3 * i);
+
+    Vector<std::string> strings;
+    for (int i = 0; i < 10; ++i)
+        strings.push_back(std::to_string(i));
+
+    REQUIRE(strings.erase_if([](const std::string& x) { return x < "5"; }) == 5);
+    REQUIRE(strings[0] == "5");
+    REQUIRE(strings.back() == "9");
+}
+
+TEST_CASE("unordered_erase test", "[erase][unordered_erase]")
+{
+    Vector<std::string> strings;
+    for (int i = 0; i < 4; ++i)
+        strings.push_back(std::to_string(i));
+
+    strings.unordered_erase(strings.begin());
+    strings.unordered_erase(strings.end() - 1);
+
+    REQUIRE(strings.size() == 2);
+    REQUIRE(strings[0] == "3");
+    REQUIRE(strings[1] == "1");
+
+    Vector<int> vec(3, 1);
+    vec[2] = 5;
+    vec.unordered_erase(vec.begin());
+    REQUIRE(vec[0] == 5);
+}
+
+TEST_CASE("insert_many test", "[insert][insert_many]")
+{
+    Vector<int> vec;
+    for (int i = 0; i < 5; ++i)
+        vec.push_back(i * 10);
+
+    std::size_t positions[] = {0, 2, 2, 5};
+    int values[] = {-1, 11, 12, 99};
+    vec.insert_many(positions, positions + 4, values);
+
+    int expected[] = {-1, 0, 10, 11, 12, 20, 30, 40, 99};
+    REQUIRE(vec.size() == 9);
+    for (int i = 0; i < 9; ++i)
+        REQUIRE(vec[i] == expected[i]);
+
+    Vector<std::string> strings;
+    for (int i = 0; i < 3; ++i)
+        strings.push_back(std::to_string(i));
+
+    std::size_t string_positions[] = {1, 3};
+    std::string string_values[] = {"a", "b"};
+    strings.reserve(10);
+    strings.insert_many(string_positions, string_positions + 2, string_values);
+
+    std::string expected_strings[] = {"0", "a", "1", "2", "b"};
+    REQUIRE(strings.size() == 5);
+    for (int i = 0; i < 5; ++i)
+        REQUIRE(strings[i] == expected_strings[i]);
+
+    std::size_t alias_positions[] = {0, 5};
+    strings.shrink_to_fit();
+    strings.insert_many(alias_positions, alias_positions + 2, &strings[3]); // values alias elements, Vector grows
+
+    std::string expected_aliased[] = {"2", "0", "a", "1", "2", "b", "b"};
+    REQUIRE(strings.size() == 7);
+    for (int i = 0; i < 7; ++i)
+        REQUIRE(strings[i] == expected_aliased[i]);
+}
+
+TEST_CASE("erase_many test", "[erase][erase_many]")
+{
+    Vector<int> vec;
+    for (int i = 0; i < 10; ++i)
+        vec.push_back(i);
+
+    std::size_t positions[] = {0, 3, 3, 4, 9};
+    vec.erase_many(positions, positions + 5);
+
+    int expected[] = {1, 2, 5, 6, 7, 8};
+    REQUIRE(vec.size() == 6);
+    for (int i = 0; i < 6; ++i)
+        REQUIRE(vec[i] == expected[i]);
+
+    Vector<std::string> strings;
+    for (int i = 0; i < 5; ++i)
+        strings.push_back(std::to_string(i));
+
+    std::size_t string_positions[] = {1, 2};
+    strings.erase_many(string_positions, string_positions + 2);
+
+    REQUIRE(strings.size() == 3);
+    REQUIRE(strings[0] == "0");
+    REQUIRE(strings[1] == "3");
+    REQUIRE(strings[2] == "4");
+}
+
+TEST_CASE("copy assignment test", "[operator=][assign]")
+{
+    Vector<int> source(50, 3);
+    Vector<int> vec(100, 1);
+    int* data = &vec[0];
+
+    vec = source;
+    REQUIRE(&vec[0] == data); // buffer reused
+    REQUIRE(vec.size() == 50);
+    REQUIRE(vec[49] == 3);
+
+    Vector<std::string> strings(3, "abc");
+    Vector<std::string> other(10, "def");
+    std::string* string_data = &other[0];
+
+    other = strings;
+    REQUIRE(&other[0] == string_data);
+    REQUIRE(other.size() == 3);
+    REQUIRE(other[2] == "abc");
+
+    strings = strings;
+    REQUIRE(strings.size() == 3);
+}
+
+TEST_CASE("assign test", "[assign]")
+{
+    Vector<std::string> strings(2, "a");
+
+    strings.assign(5, "b");
+    REQUIRE(strings.size() == 5);
+    REQUIRE(strings[4] == "b");
+    strings.assign(1, strings[2]);
+    REQUIRE(strings.size() == 1);
+    REQUIRE(strings[0] == "b");
+
+    std::vector<std::string> words = {"x", "y", "z"};
+    strings.assign(words.begin(), words.end());
+    REQUIRE(strings.size() == 3);
+    REQUIRE(strings[2] == "z");
+
+    std::istringstream stream("4 5");
+    Vector<int> vec(3, 1);
+    vec.assign(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+    REQUIRE(vec.size() == 2);
+    REQUIRE(vec[1] == 5);
+}
+
+TEST_CASE("swap test", "[swap]")
+{
+    Vector<std::string> lhs(3, "a");
+    Vector<std::string> rhs(5, "b");
+    std::string* lhs_data = &lhs[0];
+
+    lhs.swap(rhs);
+    REQUIRE(lhs.size() == 5);
+    REQUIRE(rhs.size() == 3);
+    REQUIRE(&rhs[0] == lhs_data);
+
+    using std::swap;
+    swap(lhs, rhs);
+    REQUIRE(lhs.size() == 3);
+    REQUIRE(&lhs[0] == lhs_data);
+    REQUIRE(rhs[4] == "b");
+}
@@ -0,0 +1,187 @@
+#include "../SmallVector.hpp"
+#include "catch.hpp"
+
+#include <string>
+#include <type_traits>
+
+
+// Counts heap allocations made on behalf of SmallVectors
+template <typename T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    static int allocations;
+
+    CountingAllocator() {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p); }
+};
+
+template <typename T>
+int CountingAllocator<T>::allocations = 0;
+
+template <typename T, typename U>
+bool operator ==(const CountingAllocator<T>&, const CountingAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator !=(const CountingAllocator<T>&, const CountingAllocator<U>&) { return false; }
+
+struct ThrowingMove {
+    std::string value;
+
+    ThrowingMove(const char* value) : value(value) {}
+    ThrowingMove(const ThrowingMove& rhs) : value(rhs.value) {}
+    ThrowingMove(ThrowingMove&& rhs) noexcept(false) : value(std::move(rhs.value)) {}
+    ThrowingMove& operator =(const ThrowingMove& rhs) { value = rhs.value; return *this; }
+    ThrowingMove& operator =(ThrowingMove&& rhs) noexcept(false) { value = std::move(rhs.value); return *this; }
+};
+
+
+TEST_CASE("small vector test - inline storage", "[small_vector]")
+{
+    typedef SmallVector<int, 8, CountingAllocator<int>> vector_type;
+    CountingAllocator<int>::allocations = 0;
+
+    vector_type vec;
+    REQUIRE(vec.capacity() == 8);
+    for (int i = 0; i < 8; ++i)
+        vec.push_back(i);
+    vector_type reserved(5);
+    vector_type filled(8, 42);
+    REQUIRE(CountingAllocator<int>::allocations == 0);
+    REQUIRE(vec.is_inline());
+    REQUIRE(filled[7] == 42);
+
+    vec.push_back(8); // spills
+    REQUIRE(CountingAllocator<int>::allocations == 1);
+    REQUIRE(!vec.is_inline());
+    for (int i = 0; i < 9; ++i)
+        REQUIRE(vec[i] == i);
+
+    vec.erase(vec.begin() + 2, vec.end());
+    vec.shrink_to_fit(); // back to the inline buffer
+    REQUIRE(vec.is_inline());
+    REQUIRE(vec.capacity() == 8);
+    REQUIRE(vec[1] == 1);
+
+    vec.release_memory();
+    REQUIRE(vec.is_inline());
+    REQUIRE(vec.empty());
+}
+
+TEST_CASE("small vector test - copy and move", "[small_vector]")
+{
+    typedef SmallVector<std::string, 4> vector_type;
+
+    vector_type small;
+    small.push_back("a");
+    small.push_back("b");
+
+    vector_type big;
+    for (int i = 0; i < 100; ++i)
+        big.push_back(std::to_string(i));
+
+    vector_type small_copy(small);
+    vector_type big_copy(big);
+    REQUIRE(small_copy.is_inline());
+    REQUIRE(small_copy[1] == "b");
+    REQUIRE(big_copy[99] == "99");
+
+    const std::string* heap = &big[0];
+    vector_type stolen(std::move(big)); // heap buffer changes hands
+    REQUIRE(&stolen[0] == heap);
+    REQUIRE(big.empty());
+    REQUIRE(big.is_inline());
+
+    vector_type moved(std::move(small));
+    REQUIRE(moved.is_inline());
+    REQUIRE(moved[0] == "a");
+
+    big = std::move(stolen);
+    REQUIRE(&big[0] == heap);
+    small = big_copy;
+    REQUIRE(small.size() == 100);
+    big_copy = moved;
+    REQUIRE(big_copy.size() == 2);
+
+    swap(moved, big);
+    REQUIRE(moved.size() == 100);
+    REQUIRE(big.size() == 2);
+    REQUIRE(big[1] == "b");
+    swap(moved, small);
+    REQUIRE(moved[99] == "99");
+
+    // Moving through Vector would take over the inline buffer, so it isn't reachable
+    static_assert(!std::is_convertible<vector_type&, Vector<std::string, SmallBufferAllocator<std::string, 4>>&>::value,
+                  "SmallVector must not convert to its Vector base");
+    REQUIRE(moved == moved);
+    REQUIRE(moved != big);
+
+    // Separate SmallVectors compare by their elements, inline or on the heap
+    vector_type same_inline;
+    same_inline.push_back("a");
+    same_inline.push_back("b");
+    vector_type other_inline(same_inline);
+    REQUIRE(same_inline == other_inline);
+    REQUIRE(!(same_inline != other_inline));
+    REQUIRE(same_inline <= other_inline);
+    REQUIRE(same_inline >= other_inline);
+    vector_type same_heap(moved);
+    REQUIRE(!same_heap.is_inline());
+    REQUIRE(same_heap == moved);
+    other_inline.push_back("c");
+    REQUIRE(same_inline != other_inline);
+    REQUIRE(same_inline < other_inline); // prefix
+    REQUIRE(other_inline > same_inline);
+    other_inline[0] = "0";
+    REQUIRE(other_inline < same_inline);
+
+    SmallVector<vector_type, 2> nested;
+    nested.push_back(moved);
+    nested.push_back(big);
+    nested.push_back(big_copy); // relocates elements holding inline buffers
+    REQUIRE(nested[0][99] == "99");
+    REQUIRE(nested[1][1] == "b");
+    REQUIRE(nested[2][0] == "a");
+}
+
+TEST_CASE("small vector test - insert_many", "[small_vector][insert_many]")
+{
+    typedef SmallVector<int, 4, CountingAllocator<int>> vector_type;
+    CountingAllocator<int>::allocations = 0;
+
+    vector_type vec;
+    vec.push_back(0);
+    vec.push_back(10);
+    std::size_t positions[] = {0, 1};
+    int values[] = {-1, 5};
+    vec.insert_many(positions, positions + 2, values); // fills the inline buffer, no staging copy
+    REQUIRE(CountingAllocator<int>::allocations == 0);
+    REQUIRE(vec.is_inline());
+    REQUIRE(vec[1] == 0);
+    REQUIRE(vec[2] == 5);
+
+    vec.insert_many(positions, positions + 2, values); // spills exactly once
+    REQUIRE(CountingAllocator<int>::allocations == 1);
+    REQUIRE(vec.size() == 6);
+    REQUIRE(vec[0] == -1);
+    REQUIRE(vec[2] == 5);
+    REQUIRE(vec[5] == 10);
+
+    SmallVector<ThrowingMove, 4> strings;
+    strings.push_back("a");
+    strings.push_back("c");
+    ThrowingMove string_values[] = {"b"};
+    strings.insert_many(positions + 1, positions + 2, string_values);
+    REQUIRE(strings.is_inline());
+    REQUIRE(strings.size() == 3);
+    REQUIRE(strings[1].value == "b");
+    REQUIRE(strings[2].value == "c");
+}
@@ -2,13 +2,271 @@
 #include "../Vector.hpp"
 #include "catch.hpp"
 
+#include <string>
+
+
+struct Relocatable {
+    int* value;
+};
+
+template <>
+struct is_trivially_relocatable<Relocatable> : std::true_type {};
+
+// Allocator which can always grow the last allocated block in place
+template <typename T>
+struct ExpandingAllocator {
+    typedef T value_type;
+
+    static T* last_block;
+    static std::size_t expansions;
+
+    ExpandingAllocator() {}
+    template <typename U>
+    ExpandingAllocator(const ExpandingAllocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        return last_block = static_cast<T*>(::operator new((n + 1000) * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        ::operator delete(p);
+    }
+
+    bool try_expand(T* p, std::size_t old_n, std::size_t new_n)
+    {
+        (void)old_n;
+        if (p != last_block || new_n > 1000)
+            return false;
+        ++expansions;
+        return true;
+    }
+};
+
+template <typename T, typename U>
+bool operator ==(const ExpandingAllocator<T>&, const ExpandingAllocator<U>&) { return true; }
+
+template <typename T, typename U>
+bool operator !=(const ExpandingAllocator<T>&, const ExpandingAllocator<U>&) { return false; }
+
+template <typename T>
+T* ExpandingAllocator<T>::last_block = nullptr;
+
+template <typename T>
+std::size_t ExpandingAllocator<T>::expansions = 0;
+
 
 TEST_CASE("reserve test", "[reserve]")
 {
     Vector<int> vec;
     vec.reserve(10);
 
-    REQUIRE(vec.capacity() == 10);
+    // capacity covers all the memory malloc really handed out
+    REQUIRE(vec.capacity() >= 10);
+}
+
+TEST_CASE("reserve test - relocation", "[reserve][relocation]")
+{
+    static_assert(is_trivially_relocatable<int>::value, "int must be relocatable");
+    static_assert(is_trivially_relocatable<Relocatable>::value, "opt-in must be honored");
+    static_assert(!is_trivially_relocatable<std::string>::value, "std::string is not trivially copyable");
+
+    Vector<std::string> strings;
+    for (int i = 0; i < 100; ++i)
+        strings.push_back(std::string(50, 'a' + i % 26));
+    strings.reserve(1000);
+
+    REQUIRE(strings.capacity() >= 1000);
+    REQUIRE(strings.size() == 100);
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(strings[i] == std::string(50, 'a' + i % 26));
+
+    int values[3] = {1, 2, 3};
+    Vector<Relocatable> relocatables;
+    for (int i = 0; i < 3; ++i)
+        relocatables.push_back(Relocatable{&values[i]});
+    relocatables.reserve(100);
+
+    for (int i = 0; i < 3; ++i)
+        REQUIRE(relocatables[i].value == &values[i]);
+}
+
+TEST_CASE("reserve test - in place expansion", "[reserve][try_expand]")
+{
+    Vector<std::string, ExpandingAllocator<std::string>> strings;
+    strings.reserve(1);
+    strings.push_back("first");
+    std::string* data = &strings[0];
+
+    strings.reserve(500);
+
+    REQUIRE(ExpandingAllocator<std::string>::expansions == 1);
+    REQUIRE(strings.capacity() == 500);
+    REQUIRE(&strings[0] == data);
+    REQUIRE(strings[0] == "first");
+}
+
+TEST_CASE("reserve test - realloc growth", "[reserve][reallocate]")
+{
+    Vector<long> vec;
+    for (long i = 0; i < 100000; ++i)
+        vec.push_back(i);
+
+    bool preserved = true;
+    for (long i = 0; i < 100000; ++i)
+        preserved = preserved && vec[i] == i;
+
+    REQUIRE(vec.size() == 100000);
+    REQUIRE(preserved);
+
+    Vector<long, std::allocator<long>> std_vec;
+    for (long i = 0; i < 1000; ++i)
+        std_vec.push_back(i);
+
+    REQUIRE(std_vec[999] == 999);
+}
+
+TEST_CASE("reserve test - mremap growth", "[reserve][mremap]")
+{
+    typedef VectorAllocator<long> allocator_type;
+    const std::size_t big = allocator_type::mmap_threshold / sizeof(long) * 4;
+
+    Vector<long> vec;
+    vec.reserve(16);
+    for (long i = 0; i < 16; ++i)
+        vec.push_back(i);
+
+    vec.reserve(big);          // malloc -> mmap
+    vec.reserve(big * 2);      // mmap -> mremap
+    vec[big * 2 - 1 - 16] = 0; // new pages are writable
+
+    REQUIRE(vec.capacity() == big * 2);
+    for (long i = 0; i < 16; ++i)
+        REQUIRE(vec[i] == i);
+
+    allocator_type allocator;
+    long* p = allocator.allocate(big);
+    p[big - 1] = 42;
+    p = allocator.reallocate(p, big, big * 3);
+    REQUIRE(p[big - 1] == 42);
+    p = allocator.reallocate(p, big * 3, 10); // mmap -> malloc
+    p[0] = 1;
+    allocator.deallocate(p, 10);
+}
+
+TEST_CASE("growth policy test", "[push_back][growth]")
+{
+    REQUIRE(DoublingGrowth::next_capacity(8, 9, 4) == 16);
+    REQUIRE(OneAndHalfGrowth::next_capacity(8, 9, 4) == 12);
+    REQUIRE(OneAndHalfGrowth::next_capacity(1, 2, 4) == 2);
+    REQUIRE(FibonacciGrowth::next_capacity(8, 9, 4) == 13);
+    REQUIRE(FibonacciGrowth::next_capacity(13, 100, 4) == 100);
+    REQUIRE(SizeClassGrowth::next_capacity(3, 4, 12) == 10);     // 72 bytes -> 128 bytes
+    REQUIRE(SizeClassGrowth::next_capacity(1000, 1001, 8) == 2048); // 16000 bytes -> 4 pages
+    REQUIRE((LinearAfterThresholdGrowth<1024, 256>::next_capacity(256, 257, 4) == 320));
+    REQUIRE(DefaultGrowth::next_capacity(0, 1, 4) == 16);
+    REQUIRE(DefaultGrowth::next_capacity(0, 1, 256) == 1);
+    REQUIRE(DefaultGrowth::next_capacity(16, 17, 4) == 32);
+    REQUIRE(DefaultGrowth::next_capacity(16, 17, 256) == 24);
+    REQUIRE(DefaultGrowth::next_capacity(8192, 8193, 4) == 16384);
+    REQUIRE(DefaultGrowth::next_capacity(16384, 16385, 4) == 24576); // 64 KiB and up grow by 1.5x
+
+    Vector<int, std::allocator<int>, FibonacciGrowth> vec;
+    vec.push_back(0);
+    REQUIRE(vec.capacity() == 1);
+    vec.push_back(1);
+    vec.push_back(2);
+    REQUIRE(vec.capacity() == 3);
+    vec.push_back(3);
+    REQUIRE(vec.capacity() == 5);
+}
+
+TEST_CASE("reserve test - allocate_at_least", "[reserve][allocate_at_least]")
+{
+    VectorAllocator<char> allocator;
+    allocation_result<char*> block = allocator.allocate_at_least(1);
+    REQUIRE(block.count >= 1);
+    allocator.deallocate(block.ptr, block.count);
+
+    const std::size_t big = VectorAllocator<char>::mmap_threshold + 1;
+    block = allocator.allocate_at_least(big);
+    REQUIRE(block.count % 4096 == 0);
+    block.ptr[block.count - 1] = 'x';
+    allocator.deallocate(block.ptr, block.count);
+
+    Vector<char> vec;
+    vec.push_back('a');
+    std::size_t capacity = vec.capacity();
+    for (std::size_t i = 1; i < capacity; ++i)
+        vec.push_back('a');
+
+    REQUIRE(vec.capacity() == capacity); // slack was used, no reallocation
+}
+
+TEST_CASE("reserve test - elements bigger than mmap_threshold", "[reserve][mremap]")
+{
+    struct Huge {
+        char bytes[VectorAllocator<char>::mmap_threshold + 1];
+    };
+
+    VectorAllocator<Huge> allocator;
+    Huge* p = allocator.allocate(0); // empty blocks stay on malloc
+    allocator.deallocate(p, 0);
+    allocation_result<Huge*> block = allocator.allocate_at_least(0);
+    REQUIRE(block.count == 0);
+    allocator.deallocate(block.ptr, block.count);
+
+    Vector<Huge> vec(0);
+    REQUIRE(vec.capacity() == 0);
+    vec.reserve(1); // a single element is mapped
+    REQUIRE(vec.capacity() == 1);
+    vec.begin()->bytes[sizeof(Huge) - 1] = 'x';
+    vec.reserve(3);
+    REQUIRE(vec.capacity() == 3);
+    REQUIRE(vec.begin()->bytes[sizeof(Huge) - 1] == 'x');
+
+    // Odd element sizes are compared in bytes, not in whole elements
+    struct Odd {
+        char bytes[3];
+    };
+    const std::size_t below = (VectorAllocator<Odd>::mmap_threshold - 1) / sizeof(Odd);
+    allocation_result<Odd*> small = VectorAllocator<Odd>().allocate_at_least(below);
+    REQUIRE(small.count <= below); // still a malloc block
+    VectorAllocator<Odd>().deallocate(small.ptr, small.count);
+}
+
+TEST_CASE("reserve test - populated", "[reserve][populate]")
+{
+    const std::size_t big = VectorAllocator<long>::mmap_threshold / sizeof(long) * 2;
+
+    Vector<long> vec;
+    vec.push_back(7);
+    vec.reserve_populated(big);
+    REQUIRE(vec.capacity() >= big);
+    REQUIRE(vec[0] == 7);
+
+#if defined(__linux__)
+    // Fresh mapping, so every page being resident means reserve_populated faulted them in
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    const std::size_t pages = vec.capacity() * sizeof(long) / page;
+    std::vector<unsigned char> residency(pages);
+    REQUIRE(mincore(&vec[0], pages * page, &residency[0]) == 0);
+    bool resident = true;
+    for (unsigned char page_state : residency)
+        resident = resident && (page_state & 1);
+    REQUIRE(resident);
+#endif
+
+    for (std::size_t i = 1; i < big; ++i)
+        vec.push_back(i);
+    REQUIRE(vec[big - 1] == long(big - 1));
+
+    Vector<std::string> strings;
+    strings.reserve_populated(0);
+    strings.reserve_populated(10);
+    REQUIRE(strings.capacity() >= 10);
+    REQUIRE(strings.empty());
 }
 
 TEST_CASE("push_back test - single velue", "[push_back][single value]")